@@ -0,0 +1,341 @@
+#define BOOST_TEST_DYN_LINK
+
+#include <algorithms.hpp>
+#include <thread_pool.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/timer/timer.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <future>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace algorithms = thread_pool::algorithms;
+
+namespace {
+
+// Large enough to be split in a block per worker
+const size_t data_size = 100'003;
+
+std::vector<std::uint32_t> generate_data(size_t size) {
+	std::mt19937 generator{42};
+	std::vector<std::uint32_t> data(size);
+	std::generate(data.begin(), data.end(), [&generator]() { return generator() % 1000; });
+	return data;
+}
+
+// A 2x2 matrix. Their product is associative but not commutative, and the unsigned overflow keeps it exact.
+struct matrix final {
+	std::uint32_t a = 0;
+	std::uint32_t b = 0;
+	std::uint32_t c = 0;
+	std::uint32_t d = 0;
+
+	bool operator==(const matrix& other) const {
+		return a == other.a && b == other.b && c == other.c && d == other.d;
+	}
+};
+
+matrix multiply(const matrix& left, const matrix& right) {
+	return matrix{left.a * right.a + left.b * right.c, left.a * right.b + left.b * right.d,
+				  left.c * right.a + left.d * right.c, left.c * right.b + left.d * right.d};
+}
+
+} // namespace
+
+
+BOOST_AUTO_TEST_SUITE(ParallelAlgorithms)
+
+BOOST_AUTO_TEST_CASE(InclusiveScan) {
+	thread_pool::thread_pool workers{4};
+	const std::vector<std::uint32_t> data = generate_data(data_size);
+
+	std::vector<std::uint64_t> expected(data.size());
+	std::inclusive_scan(data.cbegin(), data.cend(), expected.begin(), std::plus<std::uint64_t>{});
+
+	std::vector<std::uint64_t> result(data.size());
+	const auto result_end =
+		algorithms::inclusive_scan(workers, data.cbegin(), data.cend(), result.begin(), std::plus<std::uint64_t>{});
+
+	BOOST_CHECK(result_end == result.end());
+	BOOST_CHECK_EQUAL_COLLECTIONS(result.cbegin(), result.cend(), expected.cbegin(), expected.cend());
+}
+
+BOOST_AUTO_TEST_CASE(InclusiveScanInPlace) {
+	thread_pool::thread_pool workers{4};
+	std::vector<std::uint32_t> data = generate_data(data_size);
+
+	std::vector<std::uint32_t> expected(data.size());
+	std::inclusive_scan(data.cbegin(), data.cend(), expected.begin());
+
+	algorithms::inclusive_scan(workers, data.begin(), data.end(), data.begin());
+
+	BOOST_CHECK_EQUAL_COLLECTIONS(data.cbegin(), data.cend(), expected.cbegin(), expected.cend());
+}
+
+BOOST_AUTO_TEST_CASE(ExclusiveScan) {
+	thread_pool::thread_pool workers{4};
+	const std::vector<std::uint32_t> data = generate_data(data_size);
+
+	std::vector<std::uint64_t> expected(data.size());
+	std::exclusive_scan(data.cbegin(), data.cend(), expected.begin(), std::uint64_t{7});
+
+	std::vector<std::uint64_t> result(data.size());
+	algorithms::exclusive_scan(workers, data.cbegin(), data.cend(), result.begin(), std::uint64_t{7});
+
+	BOOST_CHECK_EQUAL_COLLECTIONS(result.cbegin(), result.cend(), expected.cbegin(), expected.cend());
+}
+
+BOOST_AUTO_TEST_CASE(ScanOfNonCommutativeOperation) {
+	thread_pool::thread_pool workers{4};
+	// A few elements more than the blocks of all workers can hold, so the blocks don't have the same size.
+	const std::vector<std::uint32_t> values = generate_data(algorithms::min_block_size * 4 + 3);
+
+	std::vector<matrix> data(values.size());
+	std::transform(values.cbegin(), values.cend(), data.begin(),
+				   [](std::uint32_t value) { return matrix{value, 1, value % 7, 1}; });
+
+	std::vector<matrix> expected(data.size());
+	std::exclusive_scan(data.cbegin(), data.cend(), expected.begin(), matrix{1, 0, 0, 1}, multiply);
+
+	std::vector<matrix> result(data.size());
+	algorithms::exclusive_scan(workers, data.cbegin(), data.cend(), result.begin(), matrix{1, 0, 0, 1}, multiply);
+
+	BOOST_CHECK(result == expected);
+
+	std::inclusive_scan(data.cbegin(), data.cend(), expected.begin(), multiply);
+	algorithms::inclusive_scan(workers, data.cbegin(), data.cend(), result.begin(), multiply);
+
+	BOOST_CHECK(result == expected);
+}
+
+BOOST_AUTO_TEST_CASE(EmptyAndSmallRanges) {
+	thread_pool::thread_pool workers{4};
+	std::vector<int> empty;
+	std::vector<int> result;
+
+	BOOST_CHECK(algorithms::inclusive_scan(workers, empty.begin(), empty.end(), result.begin()) == result.begin());
+	BOOST_CHECK(algorithms::copy_if(workers, empty.begin(), empty.end(), result.begin(), [](int) { return true; }) ==
+				result.begin());
+	BOOST_CHECK(algorithms::histogram(workers, empty.begin(), empty.end(), 3, [](int) { return 0; }) ==
+				std::vector<size_t>(3));
+
+	std::vector<int> small{1, 2, 3};
+	result.resize(small.size());
+	algorithms::exclusive_scan(workers, small.begin(), small.end(), result.begin(), 0);
+	BOOST_CHECK((result == std::vector<int>{0, 1, 3}));
+}
+
+BOOST_AUTO_TEST_CASE(Histogram) {
+	thread_pool::thread_pool workers{4};
+	const std::vector<std::uint32_t> data = generate_data(data_size);
+	const size_t bins_count = 1000;
+
+	std::vector<size_t> expected(bins_count);
+	for (auto element : data)
+		++expected[element];
+
+	const std::vector<size_t> result =
+		algorithms::histogram(workers, data.cbegin(), data.cend(), bins_count, [](std::uint32_t element) { return element; });
+
+	BOOST_CHECK_EQUAL_COLLECTIONS(result.cbegin(), result.cend(), expected.cbegin(), expected.cend());
+}
+
+BOOST_AUTO_TEST_CASE(CopyIf) {
+	thread_pool::thread_pool workers{4};
+	const std::vector<std::uint32_t> data = generate_data(data_size);
+	const auto is_odd = [](std::uint32_t element) { return element % 2 == 1; };
+
+	std::vector<std::uint32_t> expected;
+	std::copy_if(data.cbegin(), data.cend(), std::back_inserter(expected), is_odd);
+
+	std::vector<std::uint32_t> result(data.size());
+	result.erase(algorithms::copy_if(workers, data.cbegin(), data.cend(), result.begin(), is_odd), result.end());
+
+	BOOST_CHECK_EQUAL_COLLECTIONS(result.cbegin(), result.cend(), expected.cbegin(), expected.cend());
+}
+
+BOOST_AUTO_TEST_CASE(StablePartition) {
+	thread_pool::thread_pool workers{4};
+	std::vector<std::uint32_t> data = generate_data(data_size);
+	// Tags each element with its position to check the stability.
+	std::vector<std::uint64_t> tagged(data.size());
+	for (size_t i = 0; i < data.size(); ++i)
+		tagged[i] = std::uint64_t{data[i]} << 32 | i;
+
+	const auto is_small = [](std::uint64_t element) { return (element >> 32) < 300; };
+
+	std::vector<std::uint64_t> expected = tagged;
+	const auto expected_partition = std::stable_partition(expected.begin(), expected.end(), is_small);
+
+	const auto partition = algorithms::stable_partition(workers, tagged.begin(), tagged.end(), is_small);
+
+	BOOST_CHECK_EQUAL(partition - tagged.begin(), expected_partition - expected.begin());
+	BOOST_CHECK_EQUAL_COLLECTIONS(tagged.cbegin(), tagged.cend(), expected.cbegin(), expected.cend());
+}
+
+BOOST_AUTO_TEST_CASE(PredicateInvokedOnce) {
+	thread_pool::thread_pool workers{4};
+	std::vector<int> data(data_size);
+	std::iota(data.begin(), data.end(), 0);
+
+	std::vector<std::atomic<int>> invocations(data.size());
+	const auto pred = [&invocations](int element) {
+		invocations[element].fetch_add(1, std::memory_order_relaxed);
+		return element % 3 == 0;
+	};
+
+	algorithms::stable_partition(workers, data.begin(), data.end(), pred);
+
+	BOOST_CHECK(std::all_of(invocations.cbegin(), invocations.cend(), [](const std::atomic<int>& count) {
+		return count.load(std::memory_order_relaxed) == 1;
+	}));
+}
+
+BOOST_AUTO_TEST_CASE(ExceptionIsRethrown) {
+	thread_pool::thread_pool workers{4};
+	std::vector<int> data(data_size);
+	std::iota(data.begin(), data.end(), 0);
+	std::vector<int> result(data.size());
+
+	BOOST_CHECK_THROW(algorithms::copy_if(workers, data.cbegin(), data.cend(), result.begin(),
+										  [](int element) {
+											  if (element == data_size - 1)
+												  throw std::runtime_error{"Last element"};
+											  return true;
+										  }),
+					  std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(CalledFromWorker) {
+	thread_pool::thread_pool workers{2};
+	const std::vector<std::uint32_t> data = generate_data(data_size);
+
+	std::vector<std::uint32_t> expected(data.size());
+	std::inclusive_scan(data.cbegin(), data.cend(), expected.begin());
+
+	// All workers are busy with jobs which wait for the other blocks of their scan.
+	std::vector<std::vector<std::uint32_t>> results(2, std::vector<std::uint32_t>(data.size()));
+	std::vector<std::future<void>> jobs;
+	for (auto& result : results)
+		jobs.push_back(workers.add_job(
+			[&workers, &data, &result]() { algorithms::inclusive_scan(workers, data.cbegin(), data.cend(), result.begin()); }));
+
+	for (auto& job : jobs)
+		job.get();
+
+	for (const auto& result : results)
+		BOOST_CHECK_EQUAL_COLLECTIONS(result.cbegin(), result.cend(), expected.cbegin(), expected.cend());
+}
+
+BOOST_AUTO_TEST_SUITE(Performance)
+
+BOOST_AUTO_TEST_CASE(std_vs_openmp_vs_algorithms) {
+	thread_pool::thread_pool workers{std::max(2u, std::thread::hardware_concurrency())};
+	const std::vector<std::uint32_t> data = generate_data(10'000'000);
+	const int size = static_cast<int>(data.size());
+	const size_t bins_count = 1000;
+
+	std::vector<std::uint32_t> output(data.size());
+
+
+	/* Inclusive scan */
+
+	boost::timer::cpu_timer std_scan_timer;
+	std::inclusive_scan(data.cbegin(), data.cend(), output.begin());
+	std_scan_timer.stop();
+
+	boost::timer::cpu_timer openmp_scan_timer;
+	{
+		std::uint32_t sum = 0;
+// clang-format off
+		#pragma omp parallel for simd reduction(inscan, + : sum)
+		// clang-format on
+		for (int i = 0; i < size; ++i) {
+			sum += data[i];
+// clang-format off
+			#pragma omp scan inclusive(sum)
+			// clang-format on
+			output[i] = sum;
+		}
+	}
+	openmp_scan_timer.stop();
+
+	boost::timer::cpu_timer scan_timer;
+	algorithms::inclusive_scan(workers, data.cbegin(), data.cend(), output.begin());
+	scan_timer.stop();
+
+
+	/* Histogram */
+
+	boost::timer::cpu_timer std_histogram_timer;
+	{
+		std::vector<size_t> counts(bins_count);
+		std::for_each(data.cbegin(), data.cend(), [&counts](std::uint32_t element) { ++counts[element]; });
+	}
+	std_histogram_timer.stop();
+
+	boost::timer::cpu_timer openmp_histogram_timer;
+	{
+		std::vector<size_t> counts(bins_count);
+		size_t* const bins = counts.data();
+// clang-format off
+		#pragma omp parallel for reduction(+ : bins[:bins_count])
+		// clang-format on
+		for (int i = 0; i < size; ++i)
+			++bins[data[i]];
+	}
+	openmp_histogram_timer.stop();
+
+	boost::timer::cpu_timer histogram_timer;
+	algorithms::histogram(workers, data.cbegin(), data.cend(), bins_count,
+						  [](std::uint32_t element) { return element; });
+	histogram_timer.stop();
+
+
+	/* copy_if and stable_partition, which OpenMP has no counterpart of */
+
+	const auto is_small = [](std::uint32_t element) { return element < 300; };
+
+	boost::timer::cpu_timer std_copy_if_timer;
+	std::copy_if(data.cbegin(), data.cend(), output.begin(), is_small);
+	std_copy_if_timer.stop();
+
+	boost::timer::cpu_timer copy_if_timer;
+	algorithms::copy_if(workers, data.cbegin(), data.cend(), output.begin(), is_small);
+	copy_if_timer.stop();
+
+	std::vector<std::uint32_t> partitioned = data;
+	boost::timer::cpu_timer std_stable_partition_timer;
+	std::stable_partition(partitioned.begin(), partitioned.end(), is_small);
+	std_stable_partition_timer.stop();
+
+	partitioned = data;
+	boost::timer::cpu_timer stable_partition_timer;
+	algorithms::stable_partition(workers, partitioned.begin(), partitioned.end(), is_small);
+	stable_partition_timer.stop();
+
+
+	/* Compare times */
+
+	BOOST_TEST_MESSAGE("WALL | inclusive_scan std: " << std_scan_timer.elapsed().wall << ", openmp: "
+													  << openmp_scan_timer.elapsed().wall
+													  << ", algorithms: " << scan_timer.elapsed().wall);
+	BOOST_TEST_MESSAGE("WALL | histogram std: " << std_histogram_timer.elapsed().wall << ", openmp: "
+												 << openmp_histogram_timer.elapsed().wall
+												 << ", algorithms: " << histogram_timer.elapsed().wall);
+	BOOST_TEST_MESSAGE("WALL | copy_if std: " << std_copy_if_timer.elapsed().wall
+											   << ", algorithms: " << copy_if_timer.elapsed().wall);
+	BOOST_TEST_MESSAGE("WALL | stable_partition std: " << std_stable_partition_timer.elapsed().wall
+														<< ", algorithms: " << stable_partition_timer.elapsed().wall);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
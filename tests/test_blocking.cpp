@@ -0,0 +1,105 @@
+#define BOOST_TEST_DYN_LINK
+
+#include <thread_pool.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+
+BOOST_AUTO_TEST_SUITE(BlockingJobs)
+
+BOOST_AUTO_TEST_CASE(CompensatesBlockedWorkers) {
+	thread_pool::thread_pool workers{2};
+
+	std::mutex release_guard;
+	std::condition_variable release_notifier;
+	bool released = false;
+
+	// Both workers block until a job which can only run on a compensating worker releases them.
+	std::vector<std::future<bool>> blocked;
+	for (int i = 0; i < 2; ++i) {
+		blocked.push_back(workers.add_job([&]() {
+			return workers.run_blocking([&]() {
+				std::unique_lock<std::mutex> lock{release_guard};
+				return release_notifier.wait_for(lock, 5s, [&]() { return released; });
+			});
+		}));
+	}
+
+	auto releaser = workers.add_job([&]() {
+		{
+			std::lock_guard<std::mutex> lock{release_guard};
+			released = true;
+		}
+		release_notifier.notify_all();
+	});
+
+	releaser.wait();
+	for (auto& result : blocked)
+		BOOST_CHECK(result.get());
+}
+
+BOOST_AUTO_TEST_CASE(RepeatedScopes) {
+	thread_pool::thread_pool workers{4};
+
+	// The compensating workers of a round retire while the workers of the next round begin blocking.
+	for (int round = 0; round < 200; ++round) {
+		std::mutex release_guard;
+		std::condition_variable release_notifier;
+		bool released = false;
+
+		std::vector<std::future<bool>> blocked;
+		for (int i = 0; i < 4; ++i) {
+			blocked.push_back(workers.add_job([&]() {
+				return workers.run_blocking([&]() {
+					std::unique_lock<std::mutex> lock{release_guard};
+					return release_notifier.wait_for(lock, 5s, [&]() { return released; });
+				});
+			}));
+		}
+
+		auto releaser = workers.add_job([&]() {
+			{
+				std::lock_guard<std::mutex> lock{release_guard};
+				released = true;
+			}
+			release_notifier.notify_all();
+		});
+
+		releaser.wait();
+		for (auto& result : blocked)
+			BOOST_REQUIRE(result.get());
+	}
+}
+
+BOOST_AUTO_TEST_CASE(RespectsLimit) {
+	thread_pool::thread_pool workers{1, 0};
+
+	std::atomic<bool> executed{false};
+
+	auto blocked = workers.add_job([&]() {
+		workers.run_blocking([]() { std::this_thread::sleep_for(100ms); });
+		return executed.load();
+	});
+	auto other = workers.add_job([&]() { executed = true; });
+
+	// Nothing compensates the only worker, so the other job waits for the blocking one.
+	BOOST_CHECK(!blocked.get());
+	other.wait();
+}
+
+BOOST_AUTO_TEST_CASE(OutsideOfWorkers) {
+	thread_pool::thread_pool workers{1};
+
+	BOOST_CHECK_EQUAL(workers.run_blocking([]() { return 42; }), 42);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,146 @@
+#define BOOST_TEST_DYN_LINK
+
+#include <future.hpp>
+#include <thread_pool.hpp>
+
+#include <boost/test/unit_test.hpp>
+#include <boost/timer/timer.hpp>
+
+#include <chrono>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace this_thread = std::this_thread;
+
+using namespace std::chrono_literals;
+
+using thread_pool::future;
+using thread_pool::promise;
+
+
+BOOST_AUTO_TEST_SUITE(LightweightFuture)
+
+BOOST_AUTO_TEST_CASE(SetBeforeGet) {
+	promise<int> p;
+	future<int> f = p.get_future();
+
+	p.set_value(42);
+
+	BOOST_CHECK(f.ready());
+	BOOST_CHECK_EQUAL(f.get(), 42);
+	BOOST_CHECK(!f.valid());
+}
+
+BOOST_AUTO_TEST_CASE(MoveOnlyValue) {
+	promise<std::unique_ptr<int>> p;
+	future<std::unique_ptr<int>> f = p.get_future();
+
+	p.set_value(std::make_unique<int>(7));
+
+	BOOST_CHECK_EQUAL(*f.get(), 7);
+}
+
+BOOST_AUTO_TEST_CASE(WaitForSleepingWaiter) {
+	promise<void> p;
+	future<void> f = p.get_future();
+
+	BOOST_CHECK(f.wait_for(10ms) == std::future_status::timeout);
+
+	std::thread setter{[&p]() {
+		this_thread::sleep_for(50ms);
+		p.set_value();
+	}};
+
+	f.wait();
+	BOOST_CHECK(f.ready());
+	BOOST_CHECK_NO_THROW(f.get());
+
+	if (setter.joinable())
+		setter.join();
+}
+
+BOOST_AUTO_TEST_CASE(Exception) {
+	promise<int> p;
+	future<int> f = p.get_future();
+
+	p.set_exception(std::make_exception_ptr(std::runtime_error{"failed"}));
+
+	BOOST_CHECK_THROW(f.get(), std::runtime_error);
+	BOOST_CHECK_THROW(p.set_value(1), std::future_error);
+}
+
+BOOST_AUTO_TEST_CASE(BrokenPromise) {
+	future<int> f;
+	{
+		promise<int> p;
+		f = p.get_future();
+		BOOST_CHECK_THROW(p.get_future(), std::future_error);
+	}
+
+	BOOST_CHECK_THROW(f.get(), std::future_error);
+}
+
+BOOST_AUTO_TEST_CASE(AddJob) {
+	thread_pool::thread_pool workers{2};
+
+	auto result = workers.add_job([]() { return 6 * 7; }, thread_pool::thread_pool::lightweight_future);
+	BOOST_CHECK_EQUAL(result.get(), 42);
+
+	auto failure = workers.add_job([]() { throw std::runtime_error{"failed"}; },
+								   thread_pool::thread_pool::lightweight_future);
+	BOOST_CHECK_THROW(failure.get(), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE(Performance)
+
+BOOST_AUTO_TEST_CASE(std_future_vs_future) {
+	thread_pool::thread_pool workers{2};
+	const int jobs_count = 100'000;
+
+	boost::timer::cpu_timer std_future_timer;
+	{
+		std::vector<std::future<int>> results;
+		results.reserve(jobs_count);
+		for (int i = 0; i < jobs_count; ++i)
+			results.push_back(workers.add_job([i]() { return i; }));
+
+		for (auto& result : results)
+			result.get();
+	}
+	const auto std_future_times = std_future_timer.elapsed();
+
+	boost::timer::cpu_timer future_timer;
+	{
+		std::vector<future<int>> results;
+		results.reserve(jobs_count);
+		for (int i = 0; i < jobs_count; ++i)
+			results.push_back(workers.add_job([i]() { return i; }, thread_pool::thread_pool::lightweight_future));
+
+		for (auto& result : results)
+			result.get();
+	}
+	const auto future_times = future_timer.elapsed();
+
+	// A round trip of a single job measures the latency of waking up the waiter.
+	boost::timer::cpu_timer std_future_round_trip_timer;
+	for (int i = 0; i < jobs_count / 10; ++i)
+		workers.add_job([i]() { return i; }).get();
+	const auto std_future_round_trip_times = std_future_round_trip_timer.elapsed();
+
+	boost::timer::cpu_timer future_round_trip_timer;
+	for (int i = 0; i < jobs_count / 10; ++i)
+		workers.add_job([i]() { return i; }, thread_pool::thread_pool::lightweight_future).get();
+	const auto future_round_trip_times = future_round_trip_timer.elapsed();
+
+	BOOST_TEST_MESSAGE("WALL | std::future throughput: " << std_future_times.wall
+														 << ", future throughput: " << future_times.wall);
+	BOOST_TEST_MESSAGE("WALL | std::future round trip: " << std_future_round_trip_times.wall
+														 << ", future round trip: " << future_round_trip_times.wall);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,130 @@
+#define BOOST_TEST_DYN_LINK
+
+#include <pipeline.hpp>
+#include <thread_pool.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using thread_pool::pipeline;
+using thread_pool::stage_mode;
+
+struct record final {
+	int sequence;
+	std::string text;
+	long long value;
+};
+
+
+BOOST_AUTO_TEST_SUITE(Pipeline)
+
+BOOST_AUTO_TEST_CASE(ParseTransformAggregate) {
+	thread_pool::thread_pool workers{4};
+
+	const int records_count = 10'000;
+	int next_record = 0;
+
+	std::vector<int> aggregated;
+	aggregated.reserve(records_count);
+
+	pipeline<record> p{16};
+	p.source([&](record& r) {
+		 if (next_record == records_count)
+			 return false;
+
+		 r.sequence = next_record;
+		 r.text = std::to_string(next_record);
+		 ++next_record;
+		 return true;
+	 })
+		.add_stage(stage_mode::parallel, [](record& r) { r.value = std::stoll(r.text); })
+		.add_stage(stage_mode::parallel, [](record& r) { r.value *= 2; })
+		.add_stage(stage_mode::serial_in_order, [&](record& r) {
+			BOOST_REQUIRE_EQUAL(r.value, 2LL * r.sequence);
+			aggregated.push_back(r.sequence);
+		});
+
+	p.run(workers);
+
+	std::vector<int> expected(records_count);
+	std::iota(expected.begin(), expected.end(), 0);
+	BOOST_CHECK_EQUAL_COLLECTIONS(aggregated.cbegin(), aggregated.cend(), expected.cbegin(), expected.cend());
+}
+
+BOOST_AUTO_TEST_CASE(SerialOutOfOrder) {
+	thread_pool::thread_pool workers{4};
+
+	int next_value = 0;
+	std::vector<int> values;
+
+	pipeline<int> p{8};
+	p.source([&](int& value) {
+		 value = next_value;
+		 return next_value++ < 1000;
+	 })
+		.add_stage(stage_mode::parallel, [](int& value) { value *= 3; })
+		.add_stage(stage_mode::serial_out_of_order, [&](int& value) { values.push_back(value); });
+
+	p.run(workers);
+
+	BOOST_REQUIRE_EQUAL(values.size(), 1000);
+	std::sort(values.begin(), values.end());
+	for (int i = 0; i < 1000; ++i)
+		BOOST_CHECK_EQUAL(values[i], 3 * i);
+}
+
+BOOST_AUTO_TEST_CASE(MaxTokensInFlight) {
+	thread_pool::thread_pool workers{4};
+
+	const size_t max_tokens = 3;
+	int produced = 0;
+	std::atomic<int> in_flight{0};
+	std::atomic<int> peak_in_flight{0};
+
+	pipeline<int> p{max_tokens};
+	p.source([&](int&) {
+		 if (produced == 1000)
+			 return false;
+
+		 ++produced;
+		 const int current = ++in_flight;
+		 for (int peak = peak_in_flight; current > peak && !peak_in_flight.compare_exchange_weak(peak, current);)
+			 ;
+		 return true;
+	 })
+		.add_stage(stage_mode::parallel, [](int&) {})
+		.add_stage(stage_mode::serial_in_order, [&](int&) { --in_flight; });
+
+	p.run(workers);
+
+	BOOST_CHECK_EQUAL(produced, 1000);
+	BOOST_CHECK_LE(peak_in_flight, static_cast<int>(max_tokens));
+}
+
+BOOST_AUTO_TEST_CASE(StageThrows) {
+	thread_pool::thread_pool workers{2};
+
+	int next_value = 0;
+
+	pipeline<int> p{4};
+	p.source([&](int& value) {
+		 value = next_value;
+		 return next_value++ < 1000;
+	 })
+		.add_stage(stage_mode::parallel, [](int& value) {
+			if (value == 500)
+				throw std::runtime_error{"stage failed"};
+		});
+
+	BOOST_CHECK_THROW(p.run(workers), std::runtime_error);
+	BOOST_CHECK_LT(next_value, 1000);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
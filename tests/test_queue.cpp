@@ -1,14 +1,21 @@
 #define BOOST_TEST_DYN_LINK
 
 #include <data_structures/thread_safe/lock_based/queue.hpp>
+#include <data_structures/thread_safe/lock_free/spsc_queue.hpp>
 
 #include <boost/accumulators/accumulators.hpp>
 #include <boost/accumulators/statistics.hpp>
 #include <boost/test/unit_test.hpp>
 #include <boost/timer/timer.hpp>
 
+#include <chrono>
+#include <thread>
+
 using boost::timer::nanosecond_type;
+using thread_pool::data_structures::thread_safe::lock_based::bounded_queue;
+using thread_pool::data_structures::thread_safe::lock_based::contention_instrumentation;
 using thread_pool::data_structures::thread_safe::lock_based::queue;
+using thread_pool::data_structures::thread_safe::lock_free::spsc_queue;
 using thread_pool::data_structures::thread_safe::lock_based::std_queue;
 
 template <typename Q> void test_read_write(Q& queue, size_t queue_size) {
@@ -48,6 +55,82 @@ BOOST_AUTO_TEST_CASE(Pop) {
 	BOOST_CHECK(queue.empty());
 }
 
+BOOST_AUTO_TEST_CASE(BoundedPush) {
+	bounded_queue<int> queue{2};
+
+	BOOST_CHECK(queue.try_push(0));
+	BOOST_CHECK(queue.try_push(1));
+	BOOST_CHECK(!queue.try_push(2));
+	BOOST_CHECK_EQUAL(queue.pop(), 0);
+	BOOST_CHECK(queue.try_push(2));
+	BOOST_CHECK_EQUAL(queue.pop(), 1);
+	BOOST_CHECK_EQUAL(queue.pop(), 2);
+
+	BOOST_CHECK(queue.empty());
+}
+
+BOOST_AUTO_TEST_CASE(SpscPush) {
+	spsc_queue<int> queue{2};
+
+	BOOST_CHECK(queue.try_push(0));
+	BOOST_CHECK(queue.try_push(1));
+	BOOST_CHECK(!queue.try_push(2));
+
+	int element;
+	BOOST_CHECK(queue.pop(element));
+	BOOST_CHECK_EQUAL(element, 0);
+	BOOST_CHECK(queue.try_push(2));
+	BOOST_CHECK(queue.pop(element));
+	BOOST_CHECK_EQUAL(element, 1);
+	BOOST_CHECK(queue.pop(element));
+	BOOST_CHECK_EQUAL(element, 2);
+
+	BOOST_CHECK(queue.empty());
+	BOOST_CHECK(!queue.pop(element));
+}
+
+BOOST_AUTO_TEST_CASE(Uninstrumented) {
+	std_queue<int> queue;
+
+	queue.push(0);
+	BOOST_CHECK_EQUAL(queue.pop(), 0);
+
+	BOOST_CHECK_EQUAL(queue.stats().lock_acquisitions, 0);
+	BOOST_CHECK_EQUAL(queue.stats().peak_depth, 0);
+}
+
+BOOST_AUTO_TEST_CASE(InstrumentedDepth) {
+	queue<int, contention_instrumentation> queue;
+
+	queue.push(0);
+	queue.push(1);
+	queue.push(2);
+	BOOST_CHECK_EQUAL(queue.pop(), 0);
+
+	const auto stats = queue.stats();
+	for (const auto& guard_stats : {stats.head, stats.tail}) {
+		BOOST_CHECK_EQUAL(guard_stats.depth, 2);
+		BOOST_CHECK_EQUAL(guard_stats.peak_depth, 3);
+		BOOST_CHECK_EQUAL(guard_stats.try_lock_failures, 0);
+		BOOST_CHECK_EQUAL(guard_stats.wait_pop_sleeps, 0);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(InstrumentedGuards) {
+	queue<int, contention_instrumentation> queue;
+
+	queue.push(0);
+	queue.push(1);
+	queue.push(2);
+	BOOST_CHECK_EQUAL(queue.pop(), 0);
+	BOOST_CHECK(!queue.empty());
+
+	// Popping and checking for emptiness lock the head guard and then the tail guard to read the tail.
+	const auto stats = queue.stats();
+	BOOST_CHECK_EQUAL(stats.head.lock_acquisitions, 2);
+	BOOST_CHECK_EQUAL(stats.tail.lock_acquisitions, 5);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE(ReaderWriterThreads)
@@ -72,6 +155,70 @@ BOOST_AUTO_TEST_CASE(WaitPop) {
 		writer.join();
 }
 
+BOOST_AUTO_TEST_CASE(InstrumentedWaitPop) {
+	std_queue<int, contention_instrumentation> queue;
+
+	std::thread reader{[&queue]() { BOOST_CHECK_EQUAL(queue.wait_pop(), 0); }};
+
+	// Let the reader fall asleep on the empty queue.
+	std::this_thread::sleep_for(std::chrono::milliseconds{50});
+	queue.push(0);
+
+	if (reader.joinable())
+		reader.join();
+
+	const auto stats = queue.stats();
+	BOOST_CHECK_GE(stats.wait_pop_sleeps, 1);
+	BOOST_CHECK_EQUAL(stats.depth, 0);
+	BOOST_CHECK_EQUAL(stats.peak_depth, 1);
+	BOOST_CHECK_EQUAL(stats.lock_acquisitions, 2);
+}
+
+BOOST_AUTO_TEST_CASE(BoundedWaitPush) {
+	bounded_queue<int> queue{10};
+
+	std::thread reader{[&queue]() {
+		for (int i = 0; i < 1000; ++i)
+			BOOST_CHECK_EQUAL(queue.wait_pop(), i);
+	}};
+	std::thread writer{[&queue]() {
+		for (int i = 0; i < 1000; ++i) {
+			int i2 = i;
+			queue.push(std::move(i2));
+		}
+	}};
+
+	if (reader.joinable())
+		reader.join();
+	if (writer.joinable())
+		writer.join();
+}
+
+BOOST_AUTO_TEST_CASE(SpscReadWrite) {
+	spsc_queue<int> queue{10};
+
+	std::thread reader{[&queue]() {
+		for (int i = 0; i < 100'000; ++i) {
+			int element;
+			while (!queue.pop(element))
+				std::this_thread::yield();
+			BOOST_REQUIRE_EQUAL(element, i);
+		}
+	}};
+	std::thread writer{[&queue]() {
+		for (int i = 0; i < 100'000; ++i) {
+			int i2 = i;
+			while (!queue.try_push(std::move(i2)))
+				std::this_thread::yield();
+		}
+	}};
+
+	if (reader.joinable())
+		reader.join();
+	if (writer.joinable())
+		writer.join();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE(Performance)
@@ -94,6 +241,24 @@ BOOST_AUTO_TEST_CASE(std_queue_vs_queue) {
 	BOOST_TEST_MESSAGE("WALL | queue time: " << q_times.wall << ", std_queue time: " << std_q_times.wall);
 }
 
+BOOST_AUTO_TEST_CASE(Contention) {
+	queue<int, contention_instrumentation> q;
+	std_queue<int, contention_instrumentation> std_q;
+	const size_t queue_size = 1'000'000;
+
+	test_read_write(q, queue_size);
+	test_read_write(std_q, queue_size);
+
+	const auto q_stats = q.stats();
+	for (const auto& stats : {q_stats.head, q_stats.tail, std_q.stats()}) {
+		BOOST_TEST_MESSAGE("acquisitions: " << stats.lock_acquisitions << ", try_lock failures: "
+											<< stats.try_lock_failures << ", wait time: " << stats.wait_time.count()
+											<< "ns, hold time: " << stats.hold_time.count()
+											<< "ns, peak depth: " << stats.peak_depth);
+		BOOST_CHECK_EQUAL(stats.depth, 0);
+	}
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
@@ -0,0 +1,75 @@
+#define BOOST_TEST_DYN_LINK
+
+#include <strand.hpp>
+#include <thread_pool.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <future>
+#include <string>
+#include <vector>
+
+
+BOOST_AUTO_TEST_SUITE(Strands)
+
+BOOST_AUTO_TEST_CASE(SerializedInOrder) {
+	thread_pool::thread_pool workers{4};
+	thread_pool::strand session{workers};
+
+	std::atomic<int> running{0};
+	std::atomic<bool> overlapped{false};
+	std::vector<int> order;
+
+	std::vector<std::future<void>> results;
+	for (int i = 0; i < 10'000; ++i) {
+		results.push_back(session.add_job([&, i]() {
+			if (++running != 1)
+				overlapped = true;
+
+			order.push_back(i);
+			--running;
+		}));
+	}
+
+	for (auto& result : results)
+		result.wait();
+
+	BOOST_CHECK(!overlapped);
+	BOOST_REQUIRE_EQUAL(order.size(), 10'000);
+	for (int i = 0; i < 10'000; ++i)
+		BOOST_CHECK_EQUAL(order[i], i);
+}
+
+BOOST_AUTO_TEST_CASE(Result) {
+	thread_pool::thread_pool workers{2};
+	thread_pool::strand session{workers};
+
+	auto result = session.add_job([]() { return std::string{"done"}; });
+
+	BOOST_CHECK_EQUAL(result.get(), "done");
+}
+
+BOOST_AUTO_TEST_CASE(KeyedInOrder) {
+	thread_pool::thread_pool workers{4};
+	thread_pool::keyed_strand<int> sessions{workers, 8};
+
+	const int sessions_count = 32;
+	std::vector<std::vector<int>> orders(sessions_count);
+
+	std::vector<std::future<void>> results;
+	for (int i = 0; i < 1000; ++i)
+		for (int session = 0; session < sessions_count; ++session)
+			results.push_back(sessions.add_job(session, [&orders, session, i]() { orders[session].push_back(i); }));
+
+	for (auto& result : results)
+		result.wait();
+
+	for (const auto& order : orders) {
+		BOOST_REQUIRE_EQUAL(order.size(), 1000);
+		for (int i = 0; i < 1000; ++i)
+			BOOST_CHECK_EQUAL(order[i], i);
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
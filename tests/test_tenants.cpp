@@ -0,0 +1,125 @@
+#define BOOST_TEST_DYN_LINK
+
+#include <thread_pool.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace this_thread = std::this_thread;
+
+using namespace std::chrono_literals;
+
+
+BOOST_AUTO_TEST_SUITE(Tenants)
+
+BOOST_AUTO_TEST_CASE(WeightedShares) {
+	thread_pool::thread_pool workers{1};
+
+	auto light = workers.make_tenant(1);
+	auto heavy = workers.make_tenant(3);
+
+	// Hold the only worker until both tenants have their jobs queued.
+	std::atomic<bool> release{false};
+	auto blocker = workers.add_job([&release]() {
+		while (!release)
+			this_thread::yield();
+	});
+
+	std::mutex order_guard;
+	std::vector<int> order;
+
+	std::vector<std::future<void>> results;
+	for (int i = 0; i < 400; ++i) {
+		results.push_back(light->add_job([&]() {
+			std::lock_guard<std::mutex> lock{order_guard};
+			order.push_back(1);
+		}));
+		results.push_back(heavy->add_job([&]() {
+			std::lock_guard<std::mutex> lock{order_guard};
+			order.push_back(3);
+		}));
+	}
+
+	release = true;
+	for (auto& result : results)
+		result.wait();
+
+	BOOST_REQUIRE_EQUAL(order.size(), 800);
+
+	// Both tenants are backlogged during the first 400 jobs, so they share them 1:3.
+	const auto heavy_jobs = std::count(order.cbegin(), order.cbegin() + 400, 3);
+	BOOST_CHECK_GE(heavy_jobs, 299);
+	BOOST_CHECK_LE(heavy_jobs, 301);
+}
+
+BOOST_AUTO_TEST_CASE(SaturatedPoolQueue) {
+	thread_pool::thread_pool workers{1};
+
+	auto isolated = workers.make_tenant(1);
+
+	// Hold the only worker until the pool queue is saturated.
+	std::atomic<bool> release{false};
+	auto blocker = workers.add_job([&release]() {
+		while (!release)
+			this_thread::yield();
+	});
+
+	std::atomic<int> pool_jobs{0};
+	std::vector<std::future<void>> pool_results;
+	for (int i = 0; i < 1000; ++i)
+		pool_results.push_back(workers.add_job([&pool_jobs]() { ++pool_jobs; }));
+
+	std::vector<std::future<int>> tenant_results;
+	for (int i = 0; i < 10; ++i)
+		tenant_results.push_back(isolated->add_job([&pool_jobs]() { return pool_jobs.load(); }));
+
+	release = true;
+
+	// The pool queue and the tenant take turns, so the tenant doesn't wait for the whole pool queue.
+	for (int i = 0; i < 10; ++i)
+		BOOST_CHECK_LE(tenant_results[i].get(), i + 1);
+
+	for (auto& result : pool_results)
+		result.wait();
+}
+
+BOOST_AUTO_TEST_CASE(MaxConcurrency) {
+	thread_pool::thread_pool workers{4};
+
+	auto capped = workers.make_tenant(1, 2);
+
+	std::atomic<int> running{0};
+	std::atomic<int> peak_running{0};
+
+	std::vector<std::future<void>> results;
+	for (int i = 0; i < 100; ++i) {
+		results.push_back(capped->add_job([&]() {
+			const int current = ++running;
+			for (int peak = peak_running; current > peak && !peak_running.compare_exchange_weak(peak, current);)
+				;
+
+			this_thread::sleep_for(1ms);
+			--running;
+		}));
+	}
+
+	for (auto& result : results)
+		result.wait();
+
+	BOOST_CHECK_LE(peak_running, 2);
+}
+
+BOOST_AUTO_TEST_CASE(InvalidWeight) {
+	thread_pool::thread_pool workers{1};
+
+	BOOST_CHECK_THROW(workers.make_tenant(0), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
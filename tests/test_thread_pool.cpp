@@ -274,4 +274,26 @@ BOOST_AUTO_TEST_CASE(ThreadPoolProfiling) {
 	}
 }
 
+BOOST_AUTO_TEST_CASE(JobsStats) {
+	thread_pool::thread_pool workers{2};
+
+	std::vector<std::future<void>> results;
+	for (int i = 0; i < 100; ++i)
+		results.push_back(workers.add_job([]() {}));
+
+	for (auto& result : results)
+		result.wait();
+
+	const auto stats = workers.jobs_stats();
+#ifdef THREAD_POOL_QUEUE_STATS
+	// Each job is pushed and popped once. The idle workers lock the queue more.
+	BOOST_CHECK_GE(stats.lock_acquisitions, 200);
+	BOOST_CHECK_GE(stats.peak_depth, 1);
+	BOOST_CHECK_EQUAL(stats.depth, 0);
+#else
+	BOOST_CHECK_EQUAL(stats.lock_acquisitions, 0);
+	BOOST_CHECK_EQUAL(stats.peak_depth, 0);
+#endif
+}
+
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
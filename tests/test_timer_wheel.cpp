@@ -0,0 +1,192 @@
+#define BOOST_TEST_DYN_LINK
+
+#include <data_structures/timer_wheel.hpp>
+#include <thread_pool.hpp>
+
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace this_thread = std::this_thread;
+
+using namespace std::chrono_literals;
+
+using thread_pool::data_structures::timer_wheel;
+
+
+BOOST_AUTO_TEST_SUITE(TimerWheel)
+
+BOOST_AUTO_TEST_CASE(ExpiresInOrder) {
+	timer_wheel<int> wheel;
+
+	// Spans all levels of the wheel and the parked timers beyond them.
+	const std::vector<timer_wheel<int>::tick_type> expiries{0, 1, 255, 256, 257, 16'383, 16'384, 1'000'000, 70'000'000};
+	for (const auto expiry : expiries)
+		wheel.insert(std::make_shared<timer_wheel<int>::node>(static_cast<int>(expiry)), expiry);
+
+	BOOST_CHECK_EQUAL(wheel.size(), expiries.size());
+
+	std::vector<std::shared_ptr<timer_wheel<int>::node>> expired;
+	for (const auto expiry : expiries) {
+		if (expiry > 0) {
+			wheel.advance(expiry - 1, expired);
+			BOOST_CHECK(expired.empty());
+		}
+
+		wheel.advance(expiry, expired);
+		BOOST_REQUIRE_EQUAL(expired.size(), 1);
+		BOOST_CHECK_EQUAL(expired.front()->payload, static_cast<int>(expiry));
+		BOOST_CHECK(!expired.front()->linked());
+		expired.clear();
+	}
+
+	BOOST_CHECK(wheel.empty());
+}
+
+BOOST_AUTO_TEST_CASE(Erase) {
+	timer_wheel<int> wheel;
+
+	auto kept = std::make_shared<timer_wheel<int>::node>(0);
+	auto erased = std::make_shared<timer_wheel<int>::node>(1);
+	wheel.insert(kept, 300);
+	wheel.insert(erased, 300);
+
+	BOOST_CHECK(wheel.erase(*erased));
+	BOOST_CHECK(!wheel.erase(*erased));
+	BOOST_CHECK_EQUAL(wheel.size(), 1);
+
+	std::vector<std::shared_ptr<timer_wheel<int>::node>> expired;
+	wheel.advance(300, expired);
+	BOOST_REQUIRE_EQUAL(expired.size(), 1);
+	BOOST_CHECK_EQUAL(expired.front(), kept);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+BOOST_AUTO_TEST_SUITE(ScheduledJobs)
+
+BOOST_AUTO_TEST_CASE(ScheduleAfter) {
+	thread_pool::thread_pool workers{2};
+
+	std::atomic<bool> executed{false};
+	const auto scheduled = std::chrono::steady_clock::now();
+	std::atomic<std::chrono::steady_clock::time_point> executed_at{};
+
+	workers.schedule_after(20ms, [&]() {
+		executed_at = std::chrono::steady_clock::now();
+		executed = true;
+	});
+
+	while (!executed)
+		this_thread::sleep_for(1ms);
+
+	BOOST_CHECK(executed_at.load() - scheduled >= 20ms);
+}
+
+BOOST_AUTO_TEST_CASE(ScheduleAt) {
+	thread_pool::thread_pool workers{2};
+
+	std::atomic<bool> executed{false};
+	const auto due = std::chrono::steady_clock::now() + 10ms;
+
+	workers.schedule_at(due, [&]() { executed = true; });
+
+	while (!executed)
+		this_thread::sleep_for(1ms);
+
+	BOOST_CHECK(std::chrono::steady_clock::now() >= due);
+}
+
+BOOST_AUTO_TEST_CASE(Cancel) {
+	thread_pool::thread_pool workers{2};
+
+	std::atomic<bool> executed{false};
+	auto handle = workers.schedule_after(50ms, [&]() { executed = true; });
+
+	BOOST_CHECK(handle.cancel());
+	BOOST_CHECK(!handle.cancel());
+
+	this_thread::sleep_for(100ms);
+	BOOST_CHECK(!executed);
+}
+
+BOOST_AUTO_TEST_CASE(ScheduleEvery) {
+	thread_pool::thread_pool workers{2};
+
+	std::atomic<int> executions{0};
+	auto handle = workers.schedule_every(5ms, [&]() { ++executions; });
+
+	while (executions < 3)
+		this_thread::sleep_for(1ms);
+
+	BOOST_CHECK(handle.cancel());
+
+	// Let an execution which was already pending finish.
+	this_thread::sleep_for(20ms);
+	const int cancelled_at = executions;
+	this_thread::sleep_for(50ms);
+	BOOST_CHECK_EQUAL(executions, cancelled_at);
+}
+
+BOOST_AUTO_TEST_CASE(ThrowingJobs) {
+	thread_pool::thread_pool workers{2};
+
+	std::atomic<int> executions{0};
+	workers.schedule_after(1ms, []() { throw std::runtime_error{"Scheduled job"}; });
+	auto handle = workers.schedule_every(2ms, [&]() {
+		++executions;
+		throw std::runtime_error{"Periodic job"};
+	});
+
+	// The periodic job is rescheduled after it throws and the workers survive.
+	while (executions < 3)
+		this_thread::sleep_for(1ms);
+
+	BOOST_CHECK(handle.cancel());
+	BOOST_CHECK_EQUAL(workers.add_job([]() { return 42; }).get(), 42);
+}
+
+BOOST_AUTO_TEST_CASE(ScheduleDuringShutdown) {
+	struct rescheduling_job final {
+		void operator()() const {
+			workers.schedule_after(0ms, rescheduling_job{workers});
+		}
+
+		thread_pool::thread_pool& workers;
+	};
+
+	// The jobs keep scheduling themselves while the pool is destroyed.
+	for (int i = 0; i < 200; ++i) {
+		thread_pool::thread_pool workers{2};
+		workers.schedule_after(0ms, rescheduling_job{workers});
+		this_thread::sleep_for(2ms);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(ManyTimers) {
+	thread_pool::thread_pool workers{2};
+
+	const int timers_count = 100'000;
+	std::atomic<int> executions{0};
+
+	std::vector<thread_pool::thread_pool::timer_handle> handles;
+	handles.reserve(timers_count);
+	for (int i = 0; i < timers_count; ++i)
+		handles.push_back(workers.schedule_after(std::chrono::milliseconds{i % 50}, [&]() { ++executions; }));
+
+	int cancelled = 0;
+	for (int i = 0; i < timers_count; i += 2)
+		cancelled += handles[i].cancel();
+
+	while (executions + cancelled < timers_count)
+		this_thread::sleep_for(1ms);
+
+	BOOST_CHECK_EQUAL(executions + cancelled, timers_count);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
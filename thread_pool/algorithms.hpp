@@ -0,0 +1,300 @@
+#pragma once
+
+#include "future.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace thread_pool {
+
+/**
+ * @brief Parallel bulk algorithms executed on a thread_pool
+ *
+ * The input is split in one contiguous block per worker. The algorithms make two passes over the blocks: the first
+ * computes a partial result per block, then the partial results are combined serially and the second pass produces the
+ * output of each block independently. The partial results of different blocks never share a cache line.
+ */
+namespace algorithms {
+
+constexpr size_t cache_line_size = 64;
+
+/// Smaller blocks cost more to schedule than to process
+constexpr size_t min_block_size = size_t{1} << 14;
+
+template <typename T> struct alignas(cache_line_size) partial final {
+	T value;
+};
+
+inline size_t blocks_count(const thread_pool& workers, size_t size) {
+	const size_t max_blocks = std::max<size_t>(workers.workers_count(), 1);
+	return std::max<size_t>(std::min(max_blocks, (size + min_block_size - 1) / min_block_size), 1);
+}
+
+/**
+ * @brief Splits [0, @p size) in @p blocks_count blocks and executes block(index, begin, end) for each of them
+ *
+ * The calling thread executes the first block and then the pending jobs of @p workers until all blocks are done, so it
+ * may be a worker itself. Rethrows the first exception thrown by a block after all blocks are done.
+ */
+template <typename Block> void for_each_block(thread_pool& workers, size_t size, size_t blocks_count, Block& block) {
+	const size_t block_size = size / blocks_count;
+	const size_t remainder = size % blocks_count;
+	const auto block_begin = [block_size, remainder](size_t index) {
+		return index * block_size + std::min(index, remainder);
+	};
+
+	std::vector<future<void>> results;
+	results.reserve(blocks_count - 1);
+	for (size_t index = 1; index < blocks_count; ++index) {
+		results.push_back(workers.add_job(
+			[&block, index, begin = block_begin(index), end = block_begin(index + 1)]() { block(index, begin, end); },
+			thread_pool::lightweight_future));
+	}
+
+	std::exception_ptr error;
+	try {
+		block(0, block_begin(0), block_begin(1));
+	}
+	catch (...) {
+		error = std::current_exception();
+	}
+
+	// The blocks refer to the frame of the caller, so all of them must finish even if one failed.
+	for (auto& result : results) {
+		while (!result.ready())
+			workers.execute_pending_job();
+
+		try {
+			result.get();
+		}
+		catch (...) {
+			if (!error)
+				error = std::current_exception();
+		}
+	}
+
+	if (error)
+		std::rethrow_exception(error);
+}
+
+/**
+ * @brief A parallel std::inclusive_scan. @p op must be associative.
+ */
+template <typename RandomIt, typename OutputIt, typename BinaryOp = std::plus<>>
+OutputIt inclusive_scan(thread_pool& workers, RandomIt first, RandomIt last, OutputIt d_first, BinaryOp op = {}) {
+	using value_type = typename std::iterator_traits<RandomIt>::value_type;
+
+	const size_t size = static_cast<size_t>(last - first);
+	if (size == 0)
+		return d_first;
+
+	const size_t blocks = blocks_count(workers, size);
+	std::vector<partial<value_type>> sums(blocks);
+
+	auto reduce_block = [&](size_t index, size_t begin, size_t end) {
+		value_type sum = first[begin];
+		for (size_t i = begin + 1; i < end; ++i)
+			sum = op(sum, first[i]);
+		sums[index].value = sum;
+	};
+	for_each_block(workers, size, blocks, reduce_block);
+
+	// sums[index] becomes the sum of all blocks up to and including index.
+	for (size_t index = 1; index < blocks; ++index)
+		sums[index].value = op(sums[index - 1].value, sums[index].value);
+
+	auto scan_block = [&](size_t index, size_t begin, size_t end) {
+		if (index == 0)
+			std::inclusive_scan(first + begin, first + end, d_first + begin, op);
+		else
+			std::inclusive_scan(first + begin, first + end, d_first + begin, op, sums[index - 1].value);
+	};
+	for_each_block(workers, size, blocks, scan_block);
+
+	return d_first + size;
+}
+
+/**
+ * @brief A parallel std::exclusive_scan. @p op must be associative.
+ */
+template <typename RandomIt, typename OutputIt, typename T, typename BinaryOp = std::plus<>>
+OutputIt exclusive_scan(thread_pool& workers, RandomIt first, RandomIt last, OutputIt d_first, T init,
+						BinaryOp op = {}) {
+	const size_t size = static_cast<size_t>(last - first);
+	if (size == 0)
+		return d_first;
+
+	const size_t blocks = blocks_count(workers, size);
+	std::vector<partial<T>> sums(blocks);
+
+	auto reduce_block = [&](size_t index, size_t begin, size_t end) {
+		T sum = first[begin];
+		for (size_t i = begin + 1; i < end; ++i)
+			sum = op(sum, first[i]);
+		sums[index].value = sum;
+	};
+	for_each_block(workers, size, blocks, reduce_block);
+
+	// sums[index] becomes the sum of init and all blocks before index.
+	T carry = std::move(init);
+	for (size_t index = 0; index < blocks; ++index) {
+		T sum = std::move(sums[index].value);
+		sums[index].value = carry;
+		carry = op(std::move(carry), std::move(sum));
+	}
+
+	auto scan_block = [&](size_t index, size_t begin, size_t end) {
+		std::exclusive_scan(first + begin, first + end, d_first + begin, sums[index].value, op);
+	};
+	for_each_block(workers, size, blocks, scan_block);
+
+	return d_first + size;
+}
+
+/**
+ * @brief Counts the elements of each bin
+ * @param bin_of Maps an element to its bin in [0, bins_count)
+ */
+template <typename RandomIt, typename BinOf>
+std::vector<size_t> histogram(thread_pool& workers, RandomIt first, RandomIt last, size_t bins_count, BinOf bin_of) {
+	const size_t size = static_cast<size_t>(last - first);
+	const size_t blocks = blocks_count(workers, size);
+
+	// Each block counts in its own row. The rows are allocated by the worker which fills them and are padded on both
+	// sides, so the rows of different blocks never share a cache line.
+	constexpr size_t padding = cache_line_size / sizeof(size_t);
+	std::vector<std::vector<size_t>> rows(blocks);
+
+	auto count_block = [&](size_t index, size_t begin, size_t end) {
+		std::vector<size_t> row(padding + bins_count + padding);
+		size_t* const counts = row.data() + padding;
+
+		for (size_t i = begin; i < end; ++i)
+			++counts[bin_of(first[i])];
+
+		rows[index] = std::move(row);
+	};
+	for_each_block(workers, size, blocks, count_block);
+
+	std::vector<size_t> result(bins_count);
+
+	// The bins are summed in parallel as well, since there may be more of them than elements in a block.
+	auto sum_bins = [&](size_t, size_t begin, size_t end) {
+		for (const auto& row : rows) {
+			const size_t* const counts = row.data() + padding;
+			for (size_t bin = begin; bin < end; ++bin)
+				result[bin] += counts[bin];
+		}
+	};
+	for_each_block(workers, bins_count, blocks_count(workers, bins_count), sum_bins);
+
+	return result;
+}
+
+/**
+ * @brief A parallel std::copy_if. @p pred is invoked exactly once for each element.
+ *
+ * The blocks are copied to their offsets in the output at the same time, so @p d_first must be a random-access
+ * iterator into an output with room for all copied elements.
+ */
+template <typename RandomIt, typename RandomOutputIt, typename Predicate>
+RandomOutputIt copy_if(thread_pool& workers, RandomIt first, RandomIt last, RandomOutputIt d_first, Predicate pred) {
+	static_assert(std::is_base_of<std::random_access_iterator_tag,
+								  typename std::iterator_traits<RandomOutputIt>::iterator_category>::value,
+				  "The parallel copy_if requires a random-access output iterator");
+
+	const size_t size = static_cast<size_t>(last - first);
+	const size_t blocks = blocks_count(workers, size);
+
+	std::vector<unsigned char> selected(size);
+	std::vector<partial<size_t>> offsets(blocks);
+
+	auto select_block = [&](size_t index, size_t begin, size_t end) {
+		size_t count = 0;
+		for (size_t i = begin; i < end; ++i) {
+			selected[i] = pred(first[i]) ? 1 : 0;
+			count += selected[i];
+		}
+		offsets[index].value = count;
+	};
+	for_each_block(workers, size, blocks, select_block);
+
+	size_t selected_count = 0;
+	for (auto& offset : offsets)
+		selected_count += std::exchange(offset.value, selected_count);
+
+	auto copy_block = [&](size_t index, size_t begin, size_t end) {
+		RandomOutputIt output = d_first + offsets[index].value;
+		for (size_t i = begin; i < end; ++i)
+			if (selected[i])
+				*output++ = first[i];
+	};
+	for_each_block(workers, size, blocks, copy_block);
+
+	return d_first + selected_count;
+}
+
+/**
+ * @brief A parallel std::stable_partition. @p pred is invoked exactly once for each element.
+ *
+ * The elements are moved through a buffer, so they must be default-constructible and move-assignable.
+ */
+template <typename RandomIt, typename Predicate>
+RandomIt stable_partition(thread_pool& workers, RandomIt first, RandomIt last, Predicate pred) {
+	using value_type = typename std::iterator_traits<RandomIt>::value_type;
+
+	const size_t size = static_cast<size_t>(last - first);
+	const size_t blocks = blocks_count(workers, size);
+
+	std::vector<unsigned char> selected(size);
+	std::vector<partial<size_t>> true_offsets(blocks);
+
+	auto select_block = [&](size_t index, size_t begin, size_t end) {
+		size_t count = 0;
+		for (size_t i = begin; i < end; ++i) {
+			selected[i] = pred(first[i]) ? 1 : 0;
+			count += selected[i];
+		}
+		true_offsets[index].value = count;
+	};
+	for_each_block(workers, size, blocks, select_block);
+
+	size_t true_count = 0;
+	for (auto& offset : true_offsets)
+		true_count += std::exchange(offset.value, true_count);
+
+	std::vector<value_type> buffer(size);
+
+	auto scatter_block = [&](size_t index, size_t begin, size_t end) {
+		size_t true_output = true_offsets[index].value;
+		// The elements before the block which are not selected precede the ones of the block.
+		size_t false_output = true_count + (begin - true_offsets[index].value);
+
+		for (size_t i = begin; i < end; ++i) {
+			if (selected[i])
+				buffer[true_output++] = std::move(first[i]);
+			else
+				buffer[false_output++] = std::move(first[i]);
+		}
+	};
+	for_each_block(workers, size, blocks, scatter_block);
+
+	auto move_back_block = [&](size_t, size_t begin, size_t end) {
+		std::move(buffer.begin() + begin, buffer.begin() + end, first + begin);
+	};
+	for_each_block(workers, size, blocks, move_back_block);
+
+	return first + true_count;
+}
+
+} // namespace algorithms
+
+} // namespace thread_pool
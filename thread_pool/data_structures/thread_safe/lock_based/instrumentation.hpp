@@ -0,0 +1,163 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+
+namespace thread_pool {
+namespace data_structures {
+namespace thread_safe {
+namespace lock_based {
+
+struct queue_stats final {
+	std::uint64_t lock_acquisitions = 0;
+	/// Acquisitions which found the guard locked by another thread
+	std::uint64_t try_lock_failures = 0;
+	/// Time spent waiting to acquire a guard. Sleeping in wait_pop is not included.
+	std::chrono::nanoseconds wait_time{0};
+	std::chrono::nanoseconds hold_time{0};
+	std::uint64_t wait_pop_sleeps = 0;
+	std::size_t depth = 0;
+	std::size_t peak_depth = 0;
+};
+
+/**
+ * @brief The stats of a queue whose head and tail have separate guards
+ */
+struct split_queue_stats final {
+	queue_stats head;
+	queue_stats tail;
+};
+
+/**
+ * @brief The default instrumentation of the lock-based queues. It compiles to plain locking.
+ */
+class no_instrumentation {
+  public:
+	class lock final {
+	  public:
+		lock(std::mutex& guard, const no_instrumentation&) : _lock{guard} {
+		}
+
+		template <typename Predicate> void wait(std::condition_variable& notifier, Predicate predicate) {
+			notifier.wait(_lock, std::move(predicate));
+		}
+
+	  private:
+		std::unique_lock<std::mutex> _lock;
+	};
+
+	void pushed() const {
+	}
+
+	void popped() const {
+	}
+
+	queue_stats stats() const {
+		return queue_stats{};
+	}
+};
+
+/**
+ * @brief Counts the contention on the guards of a lock-based queue and tracks its depth
+ *
+ * The counters are relaxed atomics, so a stats snapshot taken while the queue is in use is not necessarily consistent.
+ */
+class contention_instrumentation {
+  public:
+	class lock final {
+	  public:
+		lock(std::mutex& guard, const contention_instrumentation& instrumentation)
+			: _instrumentation{instrumentation}, _lock{guard, std::try_to_lock} {
+			if (!_lock.owns_lock()) {
+				_instrumentation._try_lock_failures.fetch_add(1, std::memory_order_relaxed);
+
+				const auto wait_start = clock::now();
+				_lock.lock();
+				_acquired = clock::now();
+
+				_instrumentation._wait_time.fetch_add(std::chrono::nanoseconds{_acquired - wait_start}.count(),
+													  std::memory_order_relaxed);
+			}
+			else
+				_acquired = clock::now();
+
+			_instrumentation._lock_acquisitions.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		lock(const lock&) = delete;
+
+		lock& operator=(const lock&) = delete;
+
+		~lock() {
+			this->release();
+		}
+
+		template <typename Predicate> void wait(std::condition_variable& notifier, Predicate predicate) {
+			while (!predicate()) {
+				_instrumentation._wait_pop_sleeps.fetch_add(1, std::memory_order_relaxed);
+
+				this->release();
+				notifier.wait(_lock);
+				_acquired = clock::now();
+			}
+		}
+
+	  private:
+		using clock = std::chrono::steady_clock;
+
+		void release() {
+			_instrumentation._hold_time.fetch_add(std::chrono::nanoseconds{clock::now() - _acquired}.count(),
+												  std::memory_order_relaxed);
+		}
+
+		const contention_instrumentation& _instrumentation;
+		// Unlocked after the destructor measured the hold time.
+		std::unique_lock<std::mutex> _lock;
+		clock::time_point _acquired;
+	};
+
+	void pushed() const {
+		const std::size_t depth = _depth.fetch_add(1, std::memory_order_relaxed) + 1;
+
+		for (std::size_t peak = _peak_depth.load(std::memory_order_relaxed);
+			 depth > peak && !_peak_depth.compare_exchange_weak(peak, depth, std::memory_order_relaxed);)
+			;
+	}
+
+	void popped() const {
+		_depth.fetch_sub(1, std::memory_order_relaxed);
+	}
+
+	queue_stats stats() const {
+		queue_stats result;
+
+		result.lock_acquisitions = _lock_acquisitions.load(std::memory_order_relaxed);
+		result.try_lock_failures = _try_lock_failures.load(std::memory_order_relaxed);
+		result.wait_time = std::chrono::nanoseconds{_wait_time.load(std::memory_order_relaxed)};
+		result.hold_time = std::chrono::nanoseconds{_hold_time.load(std::memory_order_relaxed)};
+		result.wait_pop_sleeps = _wait_pop_sleeps.load(std::memory_order_relaxed);
+		result.depth = _depth.load(std::memory_order_relaxed);
+		result.peak_depth = _peak_depth.load(std::memory_order_relaxed);
+
+		return result;
+	}
+
+  private:
+	mutable std::atomic<std::uint64_t> _lock_acquisitions{0};
+	mutable std::atomic<std::uint64_t> _try_lock_failures{0};
+	mutable std::atomic<std::chrono::nanoseconds::rep> _wait_time{0};
+	mutable std::atomic<std::chrono::nanoseconds::rep> _hold_time{0};
+	mutable std::atomic<std::uint64_t> _wait_pop_sleeps{0};
+	mutable std::atomic<std::size_t> _depth{0};
+	mutable std::atomic<std::size_t> _peak_depth{0};
+};
+
+} // namespace lock_based
+} // namespace thread_safe
+} // namespace data_structures
+} // namespace thread_pool
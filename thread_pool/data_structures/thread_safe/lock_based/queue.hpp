@@ -1,5 +1,7 @@
 #pragma once
 
+#include "instrumentation.hpp"
+
 #include <functional>
 #include <iostream>
 #include <mutex>
@@ -11,7 +13,7 @@ namespace data_structures {
 namespace thread_safe {
 namespace lock_based {
 
-template <typename T> class queue {
+template <typename T, typename Instrumentation = no_instrumentation> class queue {
 	static_assert(std::is_nothrow_move_constructible<T>::value,
 				  "The thread-safe queue requires nothrowable move-constructible elements");
 
@@ -36,22 +38,24 @@ template <typename T> class queue {
 		std::unique_ptr<node> tail = std::make_unique<node>(std::move(data));
 
 		{
-			std::lock_guard<std::mutex> lock{_tail_guard};
+			typename Instrumentation::lock lock{_tail_guard, _tail_instrumentation};
 
 			node* const new_tail = tail.get();
 			_tail->next_node = std::move(tail);
 			_tail = new_tail;
+			_tail_instrumentation.pushed();
 		}
 
 		_notifier.notify_one();
 	}
 
 	T pop() {
-		std::lock_guard<std::mutex> lock{_head_guard};
+		typename Instrumentation::lock lock{_head_guard, _head_instrumentation};
 
 		if (_head.get() != this->get_tail()) {
 			T head = std::move(_head->next_node->data);
 			_head = std::move(_head->next_node);
+			_tail_instrumentation.popped();
 			return head;
 		}
 		else
@@ -59,11 +63,12 @@ template <typename T> class queue {
 	}
 
 	bool pop(T& out) {
-		std::lock_guard<std::mutex> lock{_head_guard};
+		typename Instrumentation::lock lock{_head_guard, _head_instrumentation};
 
 		if (_head.get() != this->get_tail()) {
 			out = std::move(_head->next_node->data);
 			_head = std::move(_head->next_node);
+			_tail_instrumentation.popped();
 			return true;
 		}
 
@@ -71,21 +76,32 @@ template <typename T> class queue {
 	}
 
 	T wait_pop() {
-		std::unique_lock<std::mutex> lock{_head_guard};
+		typename Instrumentation::lock lock{_head_guard, _head_instrumentation};
 
-		_notifier.wait(lock, [this]() { return _head.get() != this->get_tail(); });
+		lock.wait(_notifier, [this]() { return _head.get() != this->get_tail(); });
 
 		T head = std::move(_head->next_node->data);
 		_head = std::move(_head->next_node);
+		_tail_instrumentation.popped();
 		return head;
 	}
 
 	bool empty() const {
-		std::lock_guard<std::mutex> lock{_head_guard};
+		typename Instrumentation::lock lock{_head_guard, _head_instrumentation};
 
 		return _head.get() == this->get_tail();
 	}
 
+	/**
+	 * @return The contention on each guard. The depth and the peak depth are of the whole queue in both.
+	 */
+	split_queue_stats stats() const {
+		split_queue_stats result{_head_instrumentation.stats(), _tail_instrumentation.stats()};
+		result.head.depth = result.tail.depth;
+		result.head.peak_depth = result.tail.peak_depth;
+		return result;
+	}
+
   private:
 	struct node {
 		node() = default;
@@ -111,7 +127,7 @@ template <typename T> class queue {
 	};
 
 	node* get_tail() const {
-		std::lock_guard<std::mutex> lock{_tail_guard};
+		typename Instrumentation::lock lock{_tail_guard, _tail_instrumentation};
 
 		return _tail;
 	}
@@ -122,6 +138,9 @@ template <typename T> class queue {
 	mutable std::mutex _tail_guard;
 	node* _tail;
 	std::condition_variable _notifier;
+	Instrumentation _head_instrumentation;
+	// Also tracks the depth, since pushing and popping are guarded by different guards.
+	Instrumentation _tail_instrumentation;
 };
 
 /**
@@ -130,7 +149,7 @@ template <typename T> class queue {
  * constructor
  */
 
-template <typename T> class std_queue {
+template <typename T, typename Instrumentation = no_instrumentation> class std_queue : private Instrumentation {
 	static_assert(std::is_nothrow_move_constructible<T>::value,
 				  "The thread-safe queue requires nothrowable move-constructible elements");
 
@@ -139,30 +158,33 @@ template <typename T> class std_queue {
 
 
 	void push(T&& element) {
-		std::lock_guard<std::mutex> lock{_guard};
+		typename Instrumentation::lock lock{_guard, *this};
 
 		_queue.emplace(std::move(element));
+		this->pushed();
 
 		_notifier.notify_one();
 	}
 
 	T pop() {
-		std::lock_guard<std::mutex> lock{_guard};
+		typename Instrumentation::lock lock{_guard, *this};
 
 		if (_queue.empty())
 			throw std::logic_error{"All data was already popped!"};
 
 		T front = std::move(_queue.front());
 		_queue.pop();
+		this->popped();
 		return front;
 	}
 
 	bool pop(T& out) {
-		std::lock_guard<std::mutex> lock{_guard};
+		typename Instrumentation::lock lock{_guard, *this};
 
 		if (!_queue.empty()) {
 			out = std::move(_queue.front());
 			_queue.pop();
+			this->popped();
 			return true;
 		}
 
@@ -170,22 +192,140 @@ template <typename T> class std_queue {
 	}
 
 	T wait_pop() {
-		std::unique_lock<std::mutex> lock{_guard};
+		typename Instrumentation::lock lock{_guard, *this};
 
-		_notifier.wait(lock, [this]() { return !_queue.empty(); });
+		lock.wait(_notifier, [this]() { return !_queue.empty(); });
 
 		T front = std::move(_queue.front());
 		// Note that pop won't throw because the notifier waits until the queue is not empty.
 		_queue.pop();
+		this->popped();
 		return front;
 	}
 
+	queue_stats stats() const {
+		return Instrumentation::stats();
+	}
+
   private:
 	std::mutex _guard;
 	std::condition_variable _notifier;
 	std::queue<T> _queue;
 };
 
+/**
+ * @brief A thread-safe wrapper of std::queue which holds at most a fixed number of elements
+ * @tparam T Any move-constructable type which does not in any way lock the guard of this queue in its copy/move
+ * constructor
+ */
+
+template <typename T, typename Instrumentation = no_instrumentation> class bounded_queue : private Instrumentation {
+	static_assert(std::is_nothrow_move_constructible<T>::value,
+				  "The thread-safe queue requires nothrowable move-constructible elements");
+
+  public:
+	using value_type = T;
+
+
+	explicit bounded_queue(size_t capacity) : _capacity{capacity} {
+	}
+
+	bounded_queue(const bounded_queue&) = delete;
+
+	bounded_queue& operator=(const bounded_queue&) = delete;
+
+	~bounded_queue() = default;
+
+	/**
+	 * @brief Waits until there is room for @p element
+	 */
+	void push(T&& element) {
+		typename Instrumentation::lock lock{_guard, *this};
+
+		lock.wait(_not_full_notifier, [this]() { return _queue.size() < _capacity; });
+		_queue.emplace(std::move(element));
+		this->pushed();
+
+		_not_empty_notifier.notify_one();
+	}
+
+	bool try_push(T&& element) {
+		typename Instrumentation::lock lock{_guard, *this};
+
+		if (_queue.size() == _capacity)
+			return false;
+
+		_queue.emplace(std::move(element));
+		this->pushed();
+
+		_not_empty_notifier.notify_one();
+		return true;
+	}
+
+	T pop() {
+		typename Instrumentation::lock lock{_guard, *this};
+
+		if (_queue.empty())
+			throw std::logic_error{"All data was already popped!"};
+
+		T front = std::move(_queue.front());
+		_queue.pop();
+		this->popped();
+
+		_not_full_notifier.notify_one();
+		return front;
+	}
+
+	bool pop(T& out) {
+		typename Instrumentation::lock lock{_guard, *this};
+
+		if (!_queue.empty()) {
+			out = std::move(_queue.front());
+			_queue.pop();
+			this->popped();
+
+			_not_full_notifier.notify_one();
+			return true;
+		}
+
+		return false;
+	}
+
+	T wait_pop() {
+		typename Instrumentation::lock lock{_guard, *this};
+
+		lock.wait(_not_empty_notifier, [this]() { return !_queue.empty(); });
+
+		T front = std::move(_queue.front());
+		_queue.pop();
+		this->popped();
+
+		_not_full_notifier.notify_one();
+		return front;
+	}
+
+	bool empty() const {
+		typename Instrumentation::lock lock{_guard, *this};
+
+		return _queue.empty();
+	}
+
+	size_t capacity() const {
+		return _capacity;
+	}
+
+	queue_stats stats() const {
+		return Instrumentation::stats();
+	}
+
+  private:
+	const size_t _capacity;
+	mutable std::mutex _guard;
+	std::condition_variable _not_empty_notifier;
+	std::condition_variable _not_full_notifier;
+	std::queue<T> _queue;
+};
+
 } // namespace lock_based
 } // namespace thread_safe
 } // namespace data_structures
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace thread_pool {
+namespace data_structures {
+namespace thread_safe {
+namespace lock_free {
+
+/**
+ * @brief A bounded ring buffer for exactly one producer and one consumer at a time
+ * @tparam T Any default-constructible and move-assignable type
+ *
+ * The producer and the consumer may change between calls as long as the hand-over is synchronized.
+ */
+template <typename T> class spsc_queue {
+	static_assert(std::is_nothrow_move_assignable<T>::value,
+				  "The lock-free queue requires nothrowable move-assignable elements");
+
+  public:
+	using value_type = T;
+
+
+	// One slot is always left empty to tell a full buffer from an empty one.
+	explicit spsc_queue(size_t capacity) : _buffer(capacity + 1), _head{0}, _tail{0} {
+	}
+
+	spsc_queue(const spsc_queue&) = delete;
+
+	spsc_queue& operator=(const spsc_queue&) = delete;
+
+	~spsc_queue() = default;
+
+	bool try_push(T&& element) {
+		const size_t tail = _tail.load(std::memory_order_relaxed);
+		const size_t next_tail = this->next(tail);
+
+		if (next_tail == _head.load(std::memory_order_acquire))
+			return false;
+
+		_buffer[tail] = std::move(element);
+		_tail.store(next_tail, std::memory_order_release);
+		return true;
+	}
+
+	bool pop(T& out) {
+		const size_t head = _head.load(std::memory_order_relaxed);
+
+		if (head == _tail.load(std::memory_order_acquire))
+			return false;
+
+		out = std::move(_buffer[head]);
+		_head.store(this->next(head), std::memory_order_release);
+		return true;
+	}
+
+	bool empty() const {
+		return _head.load(std::memory_order_acquire) == _tail.load(std::memory_order_acquire);
+	}
+
+	size_t capacity() const {
+		return _buffer.size() - 1;
+	}
+
+  private:
+	static constexpr size_t cache_line_size = 64;
+
+	size_t next(size_t index) const {
+		return index + 1 == _buffer.size() ? 0 : index + 1;
+	}
+
+	std::vector<T> _buffer;
+	// The consumer and the producer don't share a cache line.
+	alignas(cache_line_size) std::atomic<size_t> _head;
+	alignas(cache_line_size) std::atomic<size_t> _tail;
+};
+
+} // namespace lock_free
+} // namespace thread_safe
+} // namespace data_structures
+} // namespace thread_pool
@@ -0,0 +1,246 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace thread_pool {
+namespace data_structures {
+
+/**
+ * @brief A hierarchical timer wheel with O(1) insertion and removal of timers
+ * @tparam T The payload of the timers
+ *
+ * The first level has a slot for each tick and every next level has slots which span the whole previous level. When
+ * the wheel reaches a slot of a higher level, its timers are cascaded to the lower levels. Timers which expire
+ * further than the wheel can represent are parked in the last level and re-cascaded until they fit.
+ *
+ * The wheel is not thread-safe.
+ */
+template <typename T> class timer_wheel final {
+	struct slot;
+
+  public:
+	using tick_type = std::uint64_t;
+
+	class node final {
+	  public:
+		template <typename... Args> explicit node(Args&&... args) : payload{std::forward<Args>(args)...} {
+		}
+
+		node(const node&) = delete;
+
+		node& operator=(const node&) = delete;
+
+		node(node&&) = delete;
+
+		node& operator=(node&&) = delete;
+
+		~node() = default;
+
+		tick_type expiry() const {
+			return _expiry;
+		}
+
+		bool linked() const {
+			return _slot != nullptr;
+		}
+
+		T payload;
+
+	  private:
+		friend class timer_wheel;
+
+		tick_type _expiry = 0;
+		node* _previous = nullptr;
+		node* _next = nullptr;
+		slot* _slot = nullptr;
+		// Keeps the node alive while it is linked in the wheel.
+		std::shared_ptr<node> _self;
+	};
+
+	timer_wheel() = default;
+
+	timer_wheel(const timer_wheel&) = delete;
+
+	timer_wheel& operator=(const timer_wheel&) = delete;
+
+	// The linked nodes point to the slots, so the wheel can't be moved.
+	timer_wheel(timer_wheel&&) = delete;
+
+	timer_wheel& operator=(timer_wheel&&) = delete;
+
+	~timer_wheel() {
+		this->clear();
+	}
+
+	/**
+	 * @brief Links a timer which will expire when the wheel reaches @p expiry
+	 *
+	 * Timers which are already due expire on the next advance.
+	 */
+	void insert(std::shared_ptr<node> timer, tick_type expiry) {
+		node& timer_node = *timer;
+		timer_node._expiry = expiry;
+		timer_node._self = std::move(timer);
+
+		this->link(timer_node);
+		++_size;
+	}
+
+	/**
+	 * @return Whether the timer was linked in the wheel
+	 */
+	bool erase(node& timer) {
+		if (!timer.linked())
+			return false;
+
+		this->unlink(timer);
+		--_size;
+
+		// The caller may hold the last reference elsewhere, so release ours after the node is no longer touched.
+		std::shared_ptr<node> self = std::move(timer._self);
+		return true;
+	}
+
+	/**
+	 * @brief Processes all ticks up to and including @p until and appends the expired timers to @p expired
+	 */
+	void advance(tick_type until, std::vector<std::shared_ptr<node>>& expired) {
+		if (_size == 0) {
+			_current_tick = std::max(_current_tick, until + 1);
+			return;
+		}
+
+		for (; _current_tick <= until; ++_current_tick) {
+			const std::size_t root_index = _current_tick & root_mask;
+
+			if (root_index == 0) {
+				for (std::size_t level = 1; level < levels_count; ++level) {
+					const std::size_t index = (_current_tick >> level_shift(level)) & level_mask;
+					this->cascade(level, index);
+
+					if (index != 0)
+						break;
+				}
+			}
+
+			slot& due = this->slot_at(0, root_index);
+			while (due.first != nullptr) {
+				node& timer = *due.first;
+				this->unlink(timer);
+				--_size;
+				expired.push_back(std::move(timer._self));
+			}
+		}
+	}
+
+	void clear() {
+		for (slot& s : _slots) {
+			while (s.first != nullptr) {
+				node& timer = *s.first;
+				this->unlink(timer);
+				std::shared_ptr<node> self = std::move(timer._self);
+			}
+		}
+
+		_size = 0;
+	}
+
+	/**
+	 * @return The next tick which will be processed by advance
+	 */
+	tick_type current_tick() const {
+		return _current_tick;
+	}
+
+	std::size_t size() const {
+		return _size;
+	}
+
+	bool empty() const {
+		return _size == 0;
+	}
+
+  private:
+	static constexpr std::size_t root_bits = 8;
+	static constexpr std::size_t root_size = std::size_t{1} << root_bits;
+	static constexpr std::size_t root_mask = root_size - 1;
+	static constexpr std::size_t level_bits = 6;
+	static constexpr std::size_t level_size = std::size_t{1} << level_bits;
+	static constexpr std::size_t level_mask = level_size - 1;
+	static constexpr std::size_t levels_count = 4;
+	static constexpr tick_type max_delta = (tick_type{1} << (root_bits + (levels_count - 1) * level_bits)) - 1;
+
+	struct slot {
+		node* first = nullptr;
+	};
+
+	static constexpr std::size_t level_shift(std::size_t level) {
+		return level == 0 ? 0 : root_bits + (level - 1) * level_bits;
+	}
+
+	slot& slot_at(std::size_t level, std::size_t index) {
+		return level == 0 ? _slots[index] : _slots[root_size + (level - 1) * level_size + index];
+	}
+
+	void link(node& timer) {
+		tick_type expiry = std::max(timer._expiry, _current_tick);
+		// Park the timers which don't fit in the wheel as far as possible. They are relinked on every cascade.
+		if (expiry - _current_tick > max_delta)
+			expiry = _current_tick + max_delta;
+
+		const tick_type delta = expiry - _current_tick;
+		std::size_t level = 0;
+		while (level + 1 < levels_count && delta >= (tick_type{1} << level_shift(level + 1)))
+			++level;
+
+		const std::size_t index = (expiry >> level_shift(level)) & (level == 0 ? root_mask : level_mask);
+		slot& s = this->slot_at(level, index);
+
+		timer._slot = &s;
+		timer._previous = nullptr;
+		timer._next = s.first;
+		if (s.first != nullptr)
+			s.first->_previous = &timer;
+		s.first = &timer;
+	}
+
+	void unlink(node& timer) {
+		if (timer._previous != nullptr)
+			timer._previous->_next = timer._next;
+		else
+			timer._slot->first = timer._next;
+
+		if (timer._next != nullptr)
+			timer._next->_previous = timer._previous;
+
+		timer._previous = nullptr;
+		timer._next = nullptr;
+		timer._slot = nullptr;
+	}
+
+	void cascade(std::size_t level, std::size_t index) {
+		slot& s = this->slot_at(level, index);
+
+		node* timer = s.first;
+		s.first = nullptr;
+
+		while (timer != nullptr) {
+			node* const next = timer->_next;
+			this->link(*timer);
+			timer = next;
+		}
+	}
+
+	std::array<slot, root_size + (levels_count - 1) * level_size> _slots;
+	std::size_t _size = 0;
+	tick_type _current_tick = 0;
+};
+
+} // namespace data_structures
+} // namespace thread_pool
@@ -0,0 +1,287 @@
+#pragma once
+
+#include "util/futex.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <future>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace thread_pool {
+
+template <typename T> class future;
+
+template <typename T> class promise;
+
+/**
+ * @brief The state shared by a promise and its future. It is a single allocation with an intrusive reference count.
+ *
+ * The readiness is a single atomic. The waiters spin on it for a while and then sleep on it with a futex. The setter
+ * makes a system call only when someone sleeps.
+ */
+template <typename T> class future_state final {
+  public:
+	using value_type = std::conditional_t<std::is_void<T>::value, std::monostate, T>;
+
+	future_state() = default;
+
+	future_state(const future_state&) = delete;
+
+	future_state& operator=(const future_state&) = delete;
+
+	~future_state() = default;
+
+	void acquire() {
+		_references.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	void release() {
+		if (_references.fetch_sub(1, std::memory_order_acq_rel) == 1)
+			delete this;
+	}
+
+	bool ready() const {
+		return _status.load(std::memory_order_acquire) == ready_status;
+	}
+
+	void wait() const {
+		if (this->spin())
+			return;
+
+		for (std::uint32_t status = _status.load(std::memory_order_acquire); status != ready_status;
+			 status = _status.load(std::memory_order_acquire)) {
+			if (this->announce_waiter(status))
+				util::futex::wait(_status, waiting_status);
+		}
+	}
+
+	template <typename Rep, typename Period> bool wait_for(std::chrono::duration<Rep, Period> timeout) const {
+		if (this->spin())
+			return true;
+
+		const auto deadline = std::chrono::steady_clock::now() + timeout;
+		for (std::uint32_t status = _status.load(std::memory_order_acquire); status != ready_status;
+			 status = _status.load(std::memory_order_acquire)) {
+			const auto now = std::chrono::steady_clock::now();
+			if (now >= deadline)
+				return false;
+
+			if (this->announce_waiter(status))
+				util::futex::wait_for(_status, waiting_status, deadline - now);
+		}
+
+		return true;
+	}
+
+	template <typename... Args> void set_value(Args&&... args) {
+		if (_status.load(std::memory_order_relaxed) == ready_status)
+			throw std::future_error{std::future_errc::promise_already_satisfied};
+
+		_value.emplace(std::forward<Args>(args)...);
+		this->publish();
+	}
+
+	void set_exception(std::exception_ptr exception) {
+		if (_status.load(std::memory_order_relaxed) == ready_status)
+			throw std::future_error{std::future_errc::promise_already_satisfied};
+
+		_exception = std::move(exception);
+		this->publish();
+	}
+
+	/**
+	 * @brief Moves the value out of a ready state or rethrows its exception
+	 */
+	value_type take() {
+		if (_exception)
+			std::rethrow_exception(_exception);
+
+		return std::move(*_value);
+	}
+
+  private:
+	static constexpr std::uint32_t pending_status = 0;
+	static constexpr std::uint32_t waiting_status = 1;
+	static constexpr std::uint32_t ready_status = 2;
+	// Short jobs finish before a sleeping waiter would even fall asleep.
+	static constexpr unsigned spin_count = 1 << 10;
+
+	bool spin() const {
+		for (unsigned spin = 0; spin < spin_count; ++spin)
+			if (this->ready())
+				return true;
+
+		return false;
+	}
+
+	/**
+	 * @return Whether the setter will wake up the waiters
+	 */
+	bool announce_waiter(std::uint32_t status) const {
+		return status == waiting_status ||
+			   _status.compare_exchange_strong(status, waiting_status, std::memory_order_acquire);
+	}
+
+	void publish() {
+		if (_status.exchange(ready_status, std::memory_order_acq_rel) == waiting_status)
+			util::futex::wake_all(_status);
+	}
+
+	std::atomic<std::uint32_t> _references{1};
+	mutable std::atomic<std::uint32_t> _status{pending_status};
+	std::optional<value_type> _value;
+	std::exception_ptr _exception;
+};
+
+/**
+ * @brief A lightweight alternative of std::future. Its result can be retrieved once.
+ */
+template <typename T> class future final {
+  public:
+	future() = default;
+
+	future(const future&) = delete;
+
+	future& operator=(const future&) = delete;
+
+	future(future&& other) noexcept : _state{std::exchange(other._state, nullptr)} {
+	}
+
+	future& operator=(future&& other) noexcept {
+		if (this != &other) {
+			this->reset();
+			_state = std::exchange(other._state, nullptr);
+		}
+
+		return *this;
+	}
+
+	~future() {
+		this->reset();
+	}
+
+	bool valid() const {
+		return _state != nullptr;
+	}
+
+	bool ready() const {
+		return this->checked_state().ready();
+	}
+
+	void wait() const {
+		this->checked_state().wait();
+	}
+
+	template <typename Rep, typename Period>
+	std::future_status wait_for(std::chrono::duration<Rep, Period> timeout) const {
+		return this->checked_state().wait_for(timeout) ? std::future_status::ready : std::future_status::timeout;
+	}
+
+	T get() {
+		future_state<T>& state = this->checked_state();
+		state.wait();
+
+		// The state is released even if it holds an exception.
+		future released{std::move(*this)};
+		if constexpr (std::is_void<T>::value)
+			state.take();
+		else
+			return state.take();
+	}
+
+  private:
+	friend class promise<T>;
+
+	explicit future(future_state<T>* state) : _state{state} {
+	}
+
+	future_state<T>& checked_state() const {
+		if (_state == nullptr)
+			throw std::future_error{std::future_errc::no_state};
+
+		return *_state;
+	}
+
+	void reset() {
+		if (_state != nullptr)
+			std::exchange(_state, nullptr)->release();
+	}
+
+	future_state<T>* _state = nullptr;
+};
+
+/**
+ * @brief A lightweight alternative of std::promise. Destroying it unsatisfied breaks the promise.
+ */
+template <typename T> class promise final {
+  public:
+	promise() : _state{new future_state<T>{}} {
+	}
+
+	promise(const promise&) = delete;
+
+	promise& operator=(const promise&) = delete;
+
+	promise(promise&& other) noexcept
+		: _state{std::exchange(other._state, nullptr)}, _future_retrieved{other._future_retrieved} {
+	}
+
+	promise& operator=(promise&& other) noexcept {
+		if (this != &other) {
+			this->abandon();
+			_state = std::exchange(other._state, nullptr);
+			_future_retrieved = other._future_retrieved;
+		}
+
+		return *this;
+	}
+
+	~promise() {
+		this->abandon();
+	}
+
+	future<T> get_future() {
+		if (_future_retrieved)
+			throw std::future_error{std::future_errc::future_already_retrieved};
+
+		_future_retrieved = true;
+		this->checked_state().acquire();
+		return future<T>{_state};
+	}
+
+	template <typename... Args> void set_value(Args&&... args) {
+		this->checked_state().set_value(std::forward<Args>(args)...);
+	}
+
+	void set_exception(std::exception_ptr exception) {
+		this->checked_state().set_exception(std::move(exception));
+	}
+
+  private:
+	future_state<T>& checked_state() const {
+		if (_state == nullptr)
+			throw std::future_error{std::future_errc::no_state};
+
+		return *_state;
+	}
+
+	void abandon() {
+		if (_state == nullptr)
+			return;
+
+		if (!_state->ready())
+			_state->set_exception(std::make_exception_ptr(std::future_error{std::future_errc::broken_promise}));
+
+		std::exchange(_state, nullptr)->release();
+	}
+
+	future_state<T>* _state;
+	bool _future_retrieved = false;
+};
+
+} // namespace thread_pool
@@ -0,0 +1,300 @@
+#pragma once
+
+#include "data_structures/thread_safe/lock_based/queue.hpp"
+#include "data_structures/thread_safe/lock_free/spsc_queue.hpp"
+#include "thread_pool.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace thread_pool {
+
+enum class stage_mode {
+	/// One token at a time in the order in which the source produced them
+	serial_in_order,
+	/// One token at a time in the order in which they arrive
+	serial_out_of_order,
+	/// Any number of tokens at a time
+	parallel
+};
+
+/**
+ * @brief Streams tokens from a source through a chain of stages executed on a thread_pool
+ * @tparam Token Any default-constructible type. The tokens are allocated once and recycled, so the source must
+ * overwrite the whole token.
+ *
+ * At most max_tokens tokens are in flight, so the memory of the pipeline doesn't grow with the input. The stages are
+ * connected by bounded channels which can hold all tokens, so a stage never waits to hand over a token.
+ */
+template <typename Token> class pipeline final {
+  public:
+	explicit pipeline(size_t max_tokens) : _tokens(max_tokens), _sequences(max_tokens) {
+		if (max_tokens == 0)
+			throw std::invalid_argument{"A pipeline requires at least one token!"};
+	}
+
+	pipeline(const pipeline&) = delete;
+
+	pipeline& operator=(const pipeline&) = delete;
+
+	~pipeline() = default;
+
+	/**
+	 * @param source Fills a token and returns true or returns false when the input is exhausted. It is executed
+	 * serially.
+	 */
+	template <typename Source> pipeline& source(Source source) {
+		_source = std::move(source);
+		return *this;
+	}
+
+	/**
+	 * @param stage Processes a token in place
+	 */
+	template <typename Stage> pipeline& add_stage(stage_mode mode, Stage stage) {
+		_stages.push_back(std::make_unique<pipeline::stage>(mode, std::move(stage)));
+		return *this;
+	}
+
+	/**
+	 * @brief Streams all tokens of the source through the stages. The calling thread executes pending jobs of @p workers
+	 * while it waits.
+	 *
+	 * Rethrows the first exception thrown by the source or by a stage after all tokens in flight are drained.
+	 */
+	void run(thread_pool& workers) {
+		if (!_source)
+			throw std::logic_error{"The pipeline has no source!"};
+
+		_workers = &workers;
+		_source_finished = false;
+		_cancelled = false;
+		_source_busy = false;
+		_next_sequence = 0;
+		_active_tokens = 0;
+		_pending_jobs = 0;
+		_error = nullptr;
+
+		// The source is serial, so a channel is single-producer single-consumer when both of its ends are serial.
+		bool producer_serial = true;
+		for (auto& s : _stages) {
+			const bool consumer_serial = s->mode != stage_mode::parallel;
+			s->input = std::make_unique<channel>(producer_serial && consumer_serial, _tokens.size());
+			s->busy = false;
+			s->next_sequence = 0;
+			s->reorder_buffer.assign(s->mode == stage_mode::serial_in_order ? _tokens.size() : 0, no_token);
+			producer_serial = consumer_serial;
+		}
+
+		// The last stage is the only producer of the free tokens once they are filled.
+		_free_tokens = std::make_unique<channel>(producer_serial, _tokens.size());
+		for (size_t token = 0; token < _tokens.size(); ++token)
+			_free_tokens->push(size_t{token});
+
+		this->schedule_source();
+
+		while (!_source_finished || _active_tokens != 0 || _pending_jobs != 0)
+			workers.execute_pending_job();
+
+		if (_error)
+			std::rethrow_exception(_error);
+	}
+
+  private:
+	static constexpr size_t no_token = static_cast<size_t>(-1);
+
+	class channel final {
+	  public:
+		channel(bool single_producer_consumer, size_t capacity) {
+			if (single_producer_consumer)
+				_spsc = std::make_unique<data_structures::thread_safe::lock_free::spsc_queue<size_t>>(capacity);
+			else
+				_mpmc = std::make_unique<data_structures::thread_safe::lock_based::bounded_queue<size_t>>(capacity);
+		}
+
+		// The channels can hold all tokens, so pushing never fails.
+		void push(size_t&& token) {
+			if (_spsc) {
+				const bool pushed = _spsc->try_push(std::move(token));
+				assert(pushed);
+				(void)pushed;
+			}
+			else
+				_mpmc->push(std::move(token));
+		}
+
+		bool pop(size_t& token) {
+			return _spsc ? _spsc->pop(token) : _mpmc->pop(token);
+		}
+
+		bool empty() const {
+			return _spsc ? _spsc->empty() : _mpmc->empty();
+		}
+
+	  private:
+		std::unique_ptr<data_structures::thread_safe::lock_free::spsc_queue<size_t>> _spsc;
+		std::unique_ptr<data_structures::thread_safe::lock_based::bounded_queue<size_t>> _mpmc;
+	};
+
+	struct stage final {
+		stage(stage_mode mode, std::function<void(Token&)> process)
+			: mode{mode}, process{std::move(process)}, busy{false} {
+		}
+
+		const stage_mode mode;
+		const std::function<void(Token&)> process;
+		std::unique_ptr<channel> input;
+		std::atomic<bool> busy;
+
+		// Only touched by the job which holds busy, so they need no synchronization.
+		size_t next_sequence = 0;
+		std::vector<size_t> reorder_buffer;
+	};
+
+	template <typename Job> void submit(Job job) {
+		++_pending_jobs;
+		_workers->add_job([this, job = std::move(job)]() {
+			job();
+			// Nothing may touch the pipeline after this, since run may return.
+			--_pending_jobs;
+		});
+	}
+
+	void schedule_source() {
+		if (!_source_finished && !_source_busy.exchange(true))
+			this->submit([this]() { this->execute_source(); });
+	}
+
+	void schedule(size_t stage_index) {
+		stage& s = *_stages[stage_index];
+
+		if (s.mode == stage_mode::parallel)
+			this->submit([this, stage_index]() { this->execute_parallel(stage_index); });
+		else if (!s.busy.exchange(true))
+			this->submit([this, stage_index]() { this->execute_serial(stage_index); });
+	}
+
+	void execute_source() {
+		do {
+			size_t token;
+			while (!_source_finished && _free_tokens->pop(token)) {
+				bool produced = false;
+				if (!_cancelled) {
+					try {
+						produced = _source(_tokens[token]);
+					}
+					catch (...) {
+						this->cancel();
+					}
+				}
+
+				if (!produced) {
+					// The token isn't returned, since the last stage is the only producer of the free tokens and run
+					// refills them.
+					_source_finished = true;
+					break;
+				}
+
+				_sequences[token] = _next_sequence++;
+				++_active_tokens;
+				this->forward(0, token);
+			}
+
+			_source_busy = false;
+		} while (!_source_finished && !_free_tokens->empty() && !_source_busy.exchange(true));
+	}
+
+	void execute_serial(size_t stage_index) {
+		stage& s = *_stages[stage_index];
+
+		do {
+			size_t token;
+			while (s.input->pop(token)) {
+				if (s.mode == stage_mode::serial_out_of_order) {
+					this->process(stage_index, token);
+					continue;
+				}
+
+				// The tokens in flight have consecutive sequence numbers, so they don't collide in the buffer.
+				s.reorder_buffer[_sequences[token] % s.reorder_buffer.size()] = token;
+
+				for (size_t* next = &s.reorder_buffer[s.next_sequence % s.reorder_buffer.size()]; *next != no_token;
+					 next = &s.reorder_buffer[s.next_sequence % s.reorder_buffer.size()]) {
+					const size_t ready = *next;
+					*next = no_token;
+					++s.next_sequence;
+					this->process(stage_index, ready);
+				}
+			}
+
+			s.busy = false;
+		} while (!s.input->empty() && !s.busy.exchange(true));
+	}
+
+	void execute_parallel(size_t stage_index) {
+		// Each token pushed to a parallel stage schedules exactly one job.
+		if (size_t token; _stages[stage_index]->input->pop(token))
+			this->process(stage_index, token);
+	}
+
+	void process(size_t stage_index, size_t token) {
+		if (!_cancelled) {
+			try {
+				_stages[stage_index]->process(_tokens[token]);
+			}
+			catch (...) {
+				this->cancel();
+			}
+		}
+
+		this->forward(stage_index + 1, token);
+	}
+
+	void forward(size_t stage_index, size_t token) {
+		if (stage_index < _stages.size()) {
+			_stages[stage_index]->input->push(std::move(token));
+			this->schedule(stage_index);
+		}
+		else {
+			_free_tokens->push(std::move(token));
+			--_active_tokens;
+			this->schedule_source();
+		}
+	}
+
+	void cancel() {
+		{
+			std::lock_guard<std::mutex> lock{_error_guard};
+			if (!_error)
+				_error = std::current_exception();
+		}
+
+		_cancelled = true;
+	}
+
+	std::vector<Token> _tokens;
+	std::vector<size_t> _sequences;
+	std::function<bool(Token&)> _source;
+	std::vector<std::unique_ptr<stage>> _stages;
+	std::unique_ptr<channel> _free_tokens;
+	thread_pool* _workers = nullptr;
+
+	std::atomic<bool> _source_finished{false};
+	std::atomic<bool> _source_busy{false};
+	std::atomic<bool> _cancelled{false};
+	// Only touched by the job which holds _source_busy.
+	size_t _next_sequence = 0;
+	std::atomic<size_t> _active_tokens{0};
+	std::atomic<size_t> _pending_jobs{0};
+
+	std::mutex _error_guard;
+	std::exception_ptr _error;
+};
+
+} // namespace thread_pool
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "thread_pool.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace thread_pool {
+
+/**
+ * @brief Executes its jobs on a thread_pool one at a time in the order in which they were added
+ *
+ * The pending jobs of a strand are executed back-to-back by one worker. A strand which has no pending jobs doesn't
+ * occupy a worker, so the workers never block waiting for a strand. The jobs may outlive the strand but not the pool.
+ */
+class strand final {
+  public:
+	explicit strand(thread_pool& workers) : _state{std::make_shared<state>(workers)} {
+	}
+
+	strand(const strand&) = delete;
+
+	strand& operator=(const strand&) = delete;
+
+	strand(strand&&) = default;
+
+	strand& operator=(strand&&) = default;
+
+	~strand() = default;
+
+	template <typename Job> std::future<typename std::result_of<Job()>::type> add_job(Job job) {
+		using JobResult = typename std::result_of<Job()>::type;
+
+		std::packaged_task<JobResult()> task{std::move(job)};
+		std::future<JobResult> result{task.get_future()};
+		state::add_job(_state, thread_pool::job_wrapper{std::move(task)});
+		return result;
+	}
+
+  private:
+	struct state final {
+		explicit state(thread_pool& workers) : workers{workers} {
+		}
+
+		static void add_job(const std::shared_ptr<state>& self, thread_pool::job_wrapper&& job) {
+			{
+				std::lock_guard<std::mutex> lock{self->guard};
+
+				self->jobs.push(std::move(job));
+				if (self->scheduled)
+					return;
+
+				self->scheduled = true;
+			}
+
+			state::schedule(self);
+		}
+
+		static void schedule(const std::shared_ptr<state>& self) {
+			self->workers.add_job([self]() { state::execute(self); });
+		}
+
+		static void execute(const std::shared_ptr<state>& self) {
+			std::queue<thread_pool::job_wrapper> batch;
+			{
+				std::lock_guard<std::mutex> lock{self->guard};
+				batch.swap(self->jobs);
+			}
+
+			for (; !batch.empty(); batch.pop())
+				batch.front().execute();
+
+			{
+				std::lock_guard<std::mutex> lock{self->guard};
+
+				if (self->jobs.empty()) {
+					self->scheduled = false;
+					return;
+				}
+			}
+
+			// Give the other pending jobs of the pool a turn before the jobs added during the batch.
+			state::schedule(self);
+		}
+
+		thread_pool& workers;
+		std::mutex guard;
+		std::queue<thread_pool::job_wrapper> jobs;
+		// Whether a job which executes the pending jobs was added to the pool
+		bool scheduled = false;
+	};
+
+	std::shared_ptr<state> _state;
+};
+
+/**
+ * @brief Serializes the jobs with the same key by mapping the keys to a fixed set of strands
+ *
+ * Jobs with different keys which hash to the same strand are serialized too, so the count of strands should be well
+ * above the count of workers.
+ */
+template <typename Key, typename Hash = std::hash<Key>> class keyed_strand final {
+  public:
+	keyed_strand(thread_pool& workers, size_t strands_count = 64, Hash hash = Hash{}) : _hash{std::move(hash)} {
+		if (strands_count == 0)
+			throw std::invalid_argument{"A keyed strand requires at least one strand!"};
+
+		_strands.reserve(strands_count);
+		for (size_t i = 0; i < strands_count; ++i)
+			_strands.emplace_back(workers);
+	}
+
+	keyed_strand(const keyed_strand&) = delete;
+
+	keyed_strand& operator=(const keyed_strand&) = delete;
+
+	~keyed_strand() = default;
+
+	template <typename Job> std::future<typename std::result_of<Job()>::type> add_job(const Key& key, Job job) {
+		return _strands[_hash(key) % _strands.size()].add_job(std::move(job));
+	}
+
+  private:
+	Hash _hash;
+	std::vector<strand> _strands;
+};
+
+} // namespace thread_pool
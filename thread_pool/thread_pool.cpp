@@ -1,7 +1,9 @@
 ﻿#include "thread_pool.hpp"
 #include "util/boost.hpp"
 
+#include <algorithm>
 #include <iostream>
+#include <stdexcept>
 #include <system_error>
 
 using util::boost::operator-;
@@ -21,10 +23,23 @@ using std::vector;
 
 namespace thread_pool {
 
+namespace {
+
+// The pool whose jobs the current thread executes, if any
+thread_local const thread_pool* this_thread_pool = nullptr;
+
+} // namespace
+
 thread_pool::thread_pool() : thread_pool{std::thread::hardware_concurrency()} {
 }
 
-thread_pool::thread_pool(size_t threads_count) : _execute{true} {
+thread_pool::thread_pool(size_t threads_count) : thread_pool{threads_count, threads_count} {
+}
+
+thread_pool::thread_pool(size_t threads_count, size_t max_compensating_workers)
+	: _execute{true}, _timers_epoch{std::chrono::steady_clock::now()}, _tenants_cursor{_active_tenants.end()},
+	  _pending_tenant_jobs{0}, _max_compensating_workers{max_compensating_workers}, _blocked_workers{0},
+	  _active_compensating_workers{0}, _idle_compensating_workers{0}, _compensating_workers_wakeups{0} {
 	_workers.reserve(threads_count);
 	_workers_stats.max_load_factor(.75f);
 	_workers_stats.reserve(_workers.size());
@@ -41,7 +56,10 @@ thread_pool::thread_pool(size_t threads_count) : _execute{true} {
 	}
 }
 
-thread_pool::thread_pool(thread_pool&& other) noexcept : _workers{move(other._workers)} {
+thread_pool::thread_pool(thread_pool&& other) noexcept
+	: _workers{move(other._workers)}, _tenants_cursor{_active_tenants.end()}, _pending_tenant_jobs{0},
+	  _max_compensating_workers{other._max_compensating_workers}, _blocked_workers{0}, _active_compensating_workers{0},
+	  _idle_compensating_workers{0}, _compensating_workers_wakeups{0} {
 }
 
 thread_pool& thread_pool::operator=(thread_pool&& other) noexcept {
@@ -52,7 +70,9 @@ thread_pool& thread_pool::operator=(thread_pool&& other) noexcept {
 
 thread_pool::~thread_pool() {
 	_execute = false;
+	this->stop_timers();
 	this->join_threads();
+	this->stop_compensating_workers();
 }
 
 void thread_pool::execute_pending_job() {
@@ -62,11 +82,15 @@ void thread_pool::execute_pending_job() {
 
 	boost::timer::cpu_timer thread_execution_timer;
 
-	if (job_wrapper job; _jobs.pop(job)) {
+	std::shared_ptr<tenant> owner;
+	if (job_wrapper job; this->pop_job(job, owner)) {
 		boost::timer::cpu_timer job_execution_timer;
 		job.execute();
 		job_execution_timer.stop();
 
+		if (owner)
+			this->finish_tenant_job(*owner);
+
 		// Only this thread can change its entry. The map is not reallocated.
 		auto worker_stats_entry = _workers_stats.find(std::this_thread::get_id());
 		if (worker_stats_entry != _workers_stats.cend()) {
@@ -98,17 +122,310 @@ void thread_pool::job_wrapper::execute() {
 
 /* thread_pool::job_wrapper definitions end */
 
+thread_pool::timer_handle thread_pool::schedule(job_wrapper&& job, std::chrono::steady_clock::duration delay,
+												data_structures::timer_wheel<timer>::tick_type period) {
+	auto scheduled = std::make_shared<timer_node>(move(job), period);
+	const auto expiry = to_ticks(std::chrono::steady_clock::now() - _timers_epoch + delay);
+
+	{
+		std::lock_guard<std::mutex> lock{_timers_guard};
+
+		// The timers thread may already be joined by the destructor, so jobs which schedule jobs while the pool is
+		// destroyed get a handle which cancels nothing.
+		if (!_execute)
+			return timer_handle{};
+
+		if (!_timers_thread.joinable())
+			_timers_thread = thread{&thread_pool::execute_timers, this};
+
+		this->insert_timer(scheduled, expiry);
+	}
+
+	// The timers thread sleeps without a deadline only while there are no timers.
+	_timers_notifier.notify_one();
+
+	return timer_handle{*this, scheduled};
+}
+
+bool thread_pool::cancel_timer(const std::weak_ptr<timer_node>& timer) {
+	const auto scheduled = timer.lock();
+	if (!scheduled)
+		return false;
+
+	std::lock_guard<std::mutex> lock{_timers_guard};
+
+	_timers.erase(*scheduled);
+	return !scheduled->payload.cancelled.exchange(true);
+}
+
+void thread_pool::execute_timers() {
+	vector<std::shared_ptr<timer_node>> expired;
+
+	std::unique_lock<std::mutex> lock{_timers_guard};
+	while (_execute) {
+		if (_timers.empty())
+			_timers_notifier.wait(lock);
+		else
+			_timers_notifier.wait_until(lock, _timers_epoch + _timers.current_tick() * timer_resolution);
+
+		const auto now = std::chrono::steady_clock::now() - _timers_epoch;
+		_timers.advance(std::chrono::floor<std::chrono::milliseconds>(now).count(), expired);
+		if (expired.empty())
+			continue;
+
+		lock.unlock();
+		for (auto& scheduled : expired)
+			_jobs.push(job_wrapper{[this, scheduled = move(scheduled)]() { this->execute_timer(scheduled); }});
+		expired.clear();
+		lock.lock();
+	}
+}
+
+void thread_pool::execute_timer(const std::shared_ptr<timer_node>& scheduled) {
+	timer& t = scheduled->payload;
+
+	// Nobody waits for a scheduled job, so its exceptions are discarded instead of escaping the worker.
+	const auto execute = [&t]() {
+		try {
+			t.job.execute();
+		}
+		catch (...) {
+		}
+	};
+
+	if (t.period == 0) {
+		// Cancelling and executing race for the flag, so a cancelled job is never executed.
+		if (!t.cancelled.exchange(true))
+			execute();
+		return;
+	}
+
+	if (t.cancelled)
+		return;
+
+	execute();
+
+	{
+		std::lock_guard<std::mutex> lock{_timers_guard};
+
+		if (t.cancelled || !_execute)
+			return;
+
+		this->insert_timer(scheduled, scheduled->expiry() + t.period);
+	}
+
+	_timers_notifier.notify_one();
+}
+
+void thread_pool::insert_timer(const std::shared_ptr<timer_node>& scheduled,
+							   data_structures::timer_wheel<timer>::tick_type expiry) {
+	// The timers thread doesn't advance an empty wheel while it sleeps. Catch up before linking against the current
+	// tick, so the next advance doesn't walk every tick the wheel was idle for.
+	if (_timers.empty()) {
+		vector<std::shared_ptr<timer_node>> expired;
+		const auto now = std::chrono::steady_clock::now() - _timers_epoch;
+		_timers.advance(std::chrono::floor<std::chrono::milliseconds>(now).count(), expired);
+	}
+
+	_timers.insert(scheduled, expiry);
+}
+
+void thread_pool::stop_timers() {
+	{
+		// Synchronizes with the timers thread so it can't miss the notification.
+		std::lock_guard<std::mutex> lock{_timers_guard};
+	}
+
+	_timers_notifier.notify_all();
+
+	if (_timers_thread.joinable())
+		_timers_thread.join();
+}
+
+std::shared_ptr<thread_pool::tenant> thread_pool::make_tenant(unsigned weight, size_t max_concurrency) {
+	if (weight == 0)
+		throw std::invalid_argument{"The weight of a tenant must be positive!"};
+
+	return std::shared_ptr<tenant>{new tenant{*this, weight, max_concurrency}};
+}
+
+void thread_pool::add_tenant_job(const std::shared_ptr<tenant>& owner, job_wrapper&& job) {
+	std::lock_guard<std::mutex> lock{_tenants_guard};
+
+	if (owner->_jobs.empty())
+		_active_tenants.push_back(owner);
+
+	owner->_jobs.push(move(job));
+	++_pending_tenant_jobs;
+}
+
+bool thread_pool::pop_job(job_wrapper& job, std::shared_ptr<tenant>& owner) {
+	if (_pending_tenant_jobs == 0)
+		return _jobs.pop(job);
+
+	std::lock_guard<std::mutex> lock{_tenants_guard};
+
+	// The jobs added directly to the pool take the turn of a tenant with weight 1 at the end of each round, so no
+	// subsystem which adds jobs to the pool can starve the tenants.
+	for (size_t visited = 0; visited <= _active_tenants.size(); ++visited) {
+		if (_tenants_cursor == _active_tenants.end()) {
+			_tenants_cursor = _active_tenants.begin();
+
+			if (_jobs.pop(job))
+				return true;
+
+			continue;
+		}
+
+		tenant& current = **_tenants_cursor;
+
+		// A tenant at its concurrency limit keeps its deficit for its next turn.
+		if (current._max_concurrency != 0 && current._running == current._max_concurrency) {
+			++_tenants_cursor;
+			continue;
+		}
+
+		if (current._deficit == 0)
+			current._deficit = current._weight;
+
+		job = move(current._jobs.front());
+		current._jobs.pop();
+		--current._deficit;
+		++current._running;
+		--_pending_tenant_jobs;
+		owner = *_tenants_cursor;
+
+		if (current._jobs.empty()) {
+			current._deficit = 0;
+			_tenants_cursor = _active_tenants.erase(_tenants_cursor);
+		}
+		else if (current._deficit == 0)
+			++_tenants_cursor;
+
+		return true;
+	}
+
+	return false;
+}
+
+void thread_pool::finish_tenant_job(tenant& owner) {
+	std::lock_guard<std::mutex> lock{_tenants_guard};
+
+	--owner._running;
+}
+
+bool thread_pool::begin_blocking() {
+	if (this_thread_pool != this)
+		return false;
+
+	const size_t blocked_workers = ++_blocked_workers;
+
+	std::lock_guard<std::mutex> lock{_compensating_workers_guard};
+
+	if (!_execute || _active_compensating_workers >= std::min(blocked_workers, _max_compensating_workers))
+		return true;
+
+	++_active_compensating_workers;
+
+	if (_idle_compensating_workers > _compensating_workers_wakeups) {
+		++_compensating_workers_wakeups;
+		_compensating_workers_notifier.notify_one();
+		return true;
+	}
+
+	// Reap the workers which exited after being idle for too long.
+	for (const std::thread::id exited : _exited_compensating_workers) {
+		auto worker = std::find_if(_compensating_workers.begin(), _compensating_workers.end(),
+								   [exited](const thread& t) { return t.get_id() == exited; });
+		worker->join();
+		_compensating_workers.erase(worker);
+	}
+	_exited_compensating_workers.clear();
+
+	try {
+		_compensating_workers.emplace_back(thread{&thread_pool::execute_compensating_jobs, this});
+	}
+	catch (const system_error&) {
+		// The blocked worker still blocks, but the pool keeps working with the other workers.
+		--_active_compensating_workers;
+	}
+
+	return true;
+}
+
+void thread_pool::end_blocking() {
+	// The compensating workers notice it after their current job and become idle.
+	--_blocked_workers;
+}
+
+void thread_pool::execute_compensating_jobs() {
+	this_thread_pool = this;
+
+	std::unique_lock<std::mutex> lock{_compensating_workers_guard};
+	while (_execute) {
+		lock.unlock();
+
+		while (_execute && _active_compensating_workers <= _blocked_workers)
+			this->execute_pending_job();
+
+		lock.lock();
+
+		// begin_blocking counts the active workers under the same guard, so it never relies on a worker which is
+		// retiring.
+		if (!_execute || _active_compensating_workers <= _blocked_workers)
+			continue;
+
+		--_active_compensating_workers;
+
+		++_idle_compensating_workers;
+		const bool woken = _compensating_workers_notifier.wait_for(lock, compensating_worker_idle_timeout, [this]() {
+			return !_execute || _compensating_workers_wakeups > 0;
+		});
+		--_idle_compensating_workers;
+
+		if (!woken || !_execute)
+			break;
+
+		--_compensating_workers_wakeups;
+	}
+
+	_exited_compensating_workers.push_back(std::this_thread::get_id());
+}
+
+void thread_pool::stop_compensating_workers() {
+	{
+		// Synchronizes with the compensating workers so they can't miss the notification.
+		std::lock_guard<std::mutex> lock{_compensating_workers_guard};
+	}
+
+	_compensating_workers_notifier.notify_all();
+
+	for (thread& worker : _compensating_workers)
+		if (worker.joinable())
+			worker.join();
+}
+
 void thread_pool::execute_pending_jobs() {
+	this_thread_pool = this;
+
 	while (_execute)
 		this->execute_pending_job();
 }
 
+size_t thread_pool::workers_count() const {
+	return _workers.size();
+}
+
 std::unordered_map<std::thread::id, thread_pool::worker_stats> thread_pool::workers_stats() const {
 	std::shared_lock<std::shared_mutex> lock{_workers_stats_guard};
 
 	return _workers_stats;
 }
 
+data_structures::thread_safe::lock_based::queue_stats thread_pool::jobs_stats() const {
+	return _jobs.stats();
+}
+
 void thread_pool::join_threads() {
 	for (thread& worker : _workers)
 		if (worker.joinable())
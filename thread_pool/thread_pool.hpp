@@ -1,14 +1,21 @@
 ﻿#pragma once
 
 #include "data_structures/thread_safe/lock_based/queue.hpp"
+#include "data_structures/timer_wheel.hpp"
+#include "future.hpp"
 
 #include <ThreadPool_Export.h>
 
 #include <boost/timer/timer.hpp>
 
 #include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <functional>
 #include <future>
+#include <list>
+#include <memory>
+#include <mutex>
 #include <queue>
 #include <shared_mutex>
 #include <thread>
@@ -16,6 +23,8 @@
 
 namespace thread_pool {
 
+class strand;
+
 class THREADPOOL_EXPORT thread_pool final {
   public:
 	struct worker_stats final {
@@ -23,11 +32,34 @@ class THREADPOOL_EXPORT thread_pool final {
 		boost::timer::cpu_times overall_time;
 	};
 
+	class timer_handle;
+
+	class tenant;
+
+	class blocking_scope;
+
+	/// Selects the add_job overload which returns a lightweight future
+	struct lightweight_future_t final {};
+
+	static constexpr lightweight_future_t lightweight_future{};
+
+	/// The granularity of the scheduled jobs. Jobs are never executed before they are due.
+	static constexpr std::chrono::milliseconds timer_resolution{1};
+
+	/// How long an idle compensating worker waits for another blocking job before it exits
+	static constexpr std::chrono::milliseconds compensating_worker_idle_timeout{1000};
+
 	thread_pool();
 
 	// TODO Make it
 	thread_pool(size_t workers_count);
 
+	/**
+	 * @param max_compensating_workers The maximum number of extra workers which execute jobs while the workers are
+	 * blocked in a blocking_scope
+	 */
+	thread_pool(size_t workers_count, size_t max_compensating_workers);
+
 	thread_pool(const thread_pool& other) = delete;
 
 	thread_pool& operator=(const thread_pool& other) = delete;
@@ -50,12 +82,95 @@ class THREADPOOL_EXPORT thread_pool final {
 		return result;
 	}
 
+	/**
+	 * @brief Adds @p job to the pending jobs. Its result is delivered through a thread_pool::future, which is cheaper
+	 * to wait on than std::future.
+	 */
+	template <typename Job>
+	future<typename std::result_of<Job()>::type> add_job(Job job, lightweight_future_t) {
+		using JobResult = typename std::result_of<Job()>::type;
+
+		promise<JobResult> job_promise;
+		future<JobResult> result{job_promise.get_future()};
+		_jobs.push(job_wrapper{[job = std::move(job), job_promise = std::move(job_promise)]() mutable {
+			try {
+				if constexpr (std::is_void<JobResult>::value) {
+					job();
+					job_promise.set_value();
+				}
+				else
+					job_promise.set_value(job());
+			}
+			catch (...) {
+				job_promise.set_exception(std::current_exception());
+			}
+		}});
+		return result;
+	}
+
+	/**
+	 * @brief Adds @p job to the pending jobs after @p delay
+	 *
+	 * The result of the job and any exception thrown by it are discarded.
+	 */
+	template <typename Rep, typename Period, typename Job>
+	timer_handle schedule_after(std::chrono::duration<Rep, Period> delay, Job job);
+
+	/**
+	 * @brief Adds @p job to the pending jobs at @p time
+	 *
+	 * The result of the job and any exception thrown by it are discarded.
+	 */
+	template <typename Clock, typename Duration, typename Job>
+	timer_handle schedule_at(std::chrono::time_point<Clock, Duration> time, Job job);
+
+	/**
+	 * @brief Adds @p job to the pending jobs every @p period until it is cancelled
+	 *
+	 * The next execution is scheduled a period after the previous was due once the previous finishes, so executions of
+	 * the same job never overlap. The results of the executions and any exceptions thrown by them are discarded, and
+	 * an execution which throws doesn't stop the next ones.
+	 */
+	template <typename Rep, typename Period, typename Job>
+	timer_handle schedule_every(std::chrono::duration<Rep, Period> period, Job job);
+
+	/**
+	 * @brief Creates an executor which shares the workers of this pool with the other tenants
+	 * @param weight The share of the workers of the tenant relative to the other tenants with pending jobs
+	 * @param max_concurrency The maximum number of jobs of the tenant executed at a time. Zero means unlimited.
+	 *
+	 * The tenants are served with deficit round-robin, so a tenant with weight 3 gets three jobs executed for each job
+	 * of a tenant with weight 1. The jobs added directly to the pool are served as a tenant with weight 1. The tenant
+	 * must not outlive the pool.
+	 */
+	std::shared_ptr<tenant> make_tenant(unsigned weight = 1, size_t max_concurrency = 0);
+
+	/**
+	 * @brief Executes @p f in a blocking_scope
+	 */
+	template <typename F> typename std::result_of<F()>::type run_blocking(F f) {
+		blocking_scope scope{*this};
+		return f();
+	}
+
 	void execute_pending_job();
 
+	size_t workers_count() const;
+
 	std::unordered_map<std::thread::id, worker_stats> workers_stats() const;
 
+	/**
+	 * @return The contention on the queue of pending jobs. It is all zeros unless the library is built with
+	 * THREAD_POOL_QUEUE_STATS.
+	 */
+	data_structures::thread_safe::lock_based::queue_stats jobs_stats() const;
+
   private:
-	class job_wrapper final {
+	// Queues its pending jobs the same way as the pool.
+	friend class strand;
+
+	// Exported since the strands execute it.
+	class THREADPOOL_EXPORT job_wrapper final {
 	  public:
 		job_wrapper() = default;
 
@@ -98,16 +213,200 @@ class THREADPOOL_EXPORT thread_pool final {
 		std::unique_ptr<callable> _job;
 	};
 
+	struct timer final {
+		timer(job_wrapper&& job, data_structures::timer_wheel<timer>::tick_type period)
+			: job{std::move(job)}, period{period}, cancelled{false} {
+		}
+
+		job_wrapper job;
+		// Zero for the jobs which are executed once.
+		data_structures::timer_wheel<timer>::tick_type period;
+		std::atomic<bool> cancelled;
+	};
+
+	using timer_node = data_structures::timer_wheel<timer>::node;
+
+	template <typename Rep, typename Period>
+	static data_structures::timer_wheel<timer>::tick_type to_ticks(std::chrono::duration<Rep, Period> duration) {
+		const auto ticks = std::chrono::ceil<std::chrono::milliseconds>(duration).count();
+		return ticks > 0 ? static_cast<data_structures::timer_wheel<timer>::tick_type>(ticks) : 0;
+	}
+
+	timer_handle schedule(job_wrapper&& job, std::chrono::steady_clock::duration delay,
+						  data_structures::timer_wheel<timer>::tick_type period);
+
+	bool cancel_timer(const std::weak_ptr<timer_node>& timer);
+
+	void execute_timers();
+
+	void execute_timer(const std::shared_ptr<timer_node>& timer);
+
+	void insert_timer(const std::shared_ptr<timer_node>& scheduled,
+					  data_structures::timer_wheel<timer>::tick_type expiry);
+
+	void stop_timers();
+
+	void add_tenant_job(const std::shared_ptr<tenant>& owner, job_wrapper&& job);
+
+	bool pop_job(job_wrapper& job, std::shared_ptr<tenant>& owner);
+
+	void finish_tenant_job(tenant& owner);
+
+	bool begin_blocking();
+
+	void end_blocking();
+
+	void execute_compensating_jobs();
+
+	void stop_compensating_workers();
+
 	void execute_pending_jobs();
 
 	void join_threads();
 
+#ifdef THREAD_POOL_QUEUE_STATS
+	using jobs_instrumentation = data_structures::thread_safe::lock_based::contention_instrumentation;
+#else
+	using jobs_instrumentation = data_structures::thread_safe::lock_based::no_instrumentation;
+#endif
+
 	// TODO research how std::atomic<bool> works
 	std::atomic<bool> _execute;
-	data_structures::thread_safe::lock_based::std_queue<job_wrapper> _jobs;
+	data_structures::thread_safe::lock_based::std_queue<job_wrapper, jobs_instrumentation> _jobs;
 	mutable std::shared_mutex _workers_stats_guard;
 	std::unordered_map<std::thread::id, worker_stats> _workers_stats;
 	std::vector<std::thread> _workers;
+	std::mutex _timers_guard;
+	std::condition_variable _timers_notifier;
+	data_structures::timer_wheel<timer> _timers;
+	std::chrono::steady_clock::time_point _timers_epoch;
+	// Started with the first scheduled job.
+	std::thread _timers_thread;
+	std::mutex _tenants_guard;
+	// The tenants with pending jobs in round-robin order
+	std::list<std::shared_ptr<tenant>> _active_tenants;
+	std::list<std::shared_ptr<tenant>>::iterator _tenants_cursor;
+	// Lets the workers skip _tenants_guard when no tenant has pending jobs.
+	std::atomic<size_t> _pending_tenant_jobs;
+	size_t _max_compensating_workers;
+	std::atomic<size_t> _blocked_workers;
+	// The compensating workers which execute jobs. The rest are idle or exiting.
+	std::atomic<size_t> _active_compensating_workers;
+	std::mutex _compensating_workers_guard;
+	std::condition_variable _compensating_workers_notifier;
+	std::vector<std::thread> _compensating_workers;
+	std::vector<std::thread::id> _exited_compensating_workers;
+	size_t _idle_compensating_workers;
+	// Activations handed to idle compensating workers which haven't woken up yet
+	size_t _compensating_workers_wakeups;
 };
 
+/**
+ * @brief Cancels a job scheduled on a thread_pool. It must not outlive the thread_pool.
+ */
+class thread_pool::timer_handle final {
+  public:
+	timer_handle() = default;
+
+	/**
+	 * @return Whether an execution of the job was prevented
+	 */
+	bool cancel() {
+		return _pool != nullptr && _pool->cancel_timer(_timer);
+	}
+
+  private:
+	friend class thread_pool;
+
+	timer_handle(thread_pool& pool, std::weak_ptr<timer_node> timer) : _pool{&pool}, _timer{std::move(timer)} {
+	}
+
+	thread_pool* _pool = nullptr;
+	std::weak_ptr<timer_node> _timer;
+};
+
+/**
+ * @brief An executor with its own queue of pending jobs which are executed by the workers of a thread_pool
+ */
+class thread_pool::tenant final : public std::enable_shared_from_this<tenant> {
+  public:
+	tenant(const tenant&) = delete;
+
+	tenant& operator=(const tenant&) = delete;
+
+	template <typename Job> std::future<typename std::result_of<Job()>::type> add_job(Job job) {
+		using JobResult = typename std::result_of<Job()>::type;
+
+		std::packaged_task<JobResult()> task{std::move(job)};
+		std::future<JobResult> result{task.get_future()};
+		_pool.add_tenant_job(this->shared_from_this(), job_wrapper{std::move(task)});
+		return result;
+	}
+
+	unsigned weight() const {
+		return _weight;
+	}
+
+	size_t max_concurrency() const {
+		return _max_concurrency;
+	}
+
+  private:
+	friend class thread_pool;
+
+	tenant(thread_pool& pool, unsigned weight, size_t max_concurrency)
+		: _pool{pool}, _weight{weight}, _max_concurrency{max_concurrency} {
+	}
+
+	thread_pool& _pool;
+	const unsigned _weight;
+	const size_t _max_concurrency;
+
+	// Guarded by the _tenants_guard of the pool.
+	std::queue<job_wrapper> _jobs;
+	unsigned _deficit = 0;
+	size_t _running = 0;
+};
+
+/**
+ * @brief Tells the pool that the current worker is about to block, so the pool executes its jobs on a compensating
+ * worker until the scope ends. It does nothing on threads which are not workers of the pool.
+ */
+class thread_pool::blocking_scope final {
+  public:
+	explicit blocking_scope(thread_pool& pool) : _pool{pool}, _blocking{pool.begin_blocking()} {
+	}
+
+	blocking_scope(const blocking_scope&) = delete;
+
+	blocking_scope& operator=(const blocking_scope&) = delete;
+
+	~blocking_scope() {
+		if (_blocking)
+			_pool.end_blocking();
+	}
+
+  private:
+	thread_pool& _pool;
+	const bool _blocking;
+};
+
+template <typename Rep, typename Period, typename Job>
+thread_pool::timer_handle thread_pool::schedule_after(std::chrono::duration<Rep, Period> delay, Job job) {
+	return this->schedule(job_wrapper{std::move(job)},
+						  std::chrono::ceil<std::chrono::steady_clock::duration>(delay), 0);
+}
+
+template <typename Clock, typename Duration, typename Job>
+thread_pool::timer_handle thread_pool::schedule_at(std::chrono::time_point<Clock, Duration> time, Job job) {
+	return this->schedule_after(time - Clock::now(), std::move(job));
+}
+
+template <typename Rep, typename Period, typename Job>
+thread_pool::timer_handle thread_pool::schedule_every(std::chrono::duration<Rep, Period> period, Job job) {
+	return this->schedule(job_wrapper{std::move(job)},
+						  std::chrono::ceil<std::chrono::steady_clock::duration>(period),
+						  std::max<data_structures::timer_wheel<timer>::tick_type>(to_ticks(period), 1));
+}
+
 } // namespace thread_pool
\ No newline at end of file
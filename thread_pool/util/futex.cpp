@@ -0,0 +1,81 @@
+#include "futex.hpp"
+
+#if defined(_WIN32)
+	#define WIN32_LEAN_AND_MEAN
+	#include <windows.h>
+#elif defined(__linux__)
+	#include <climits>
+	#include <linux/futex.h>
+	#include <sys/syscall.h>
+	#include <time.h>
+	#include <unistd.h>
+#else
+	#include <thread>
+#endif
+
+namespace util {
+
+namespace futex {
+
+static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t),
+			  "The futex requires an atomic with the layout of its value");
+
+#if defined(_WIN32)
+
+void wait(const std::atomic<std::uint32_t>& address, std::uint32_t expected) {
+	WaitOnAddress(const_cast<std::atomic<std::uint32_t>*>(&address), &expected, sizeof(expected), INFINITE);
+}
+
+void wait_for(const std::atomic<std::uint32_t>& address, std::uint32_t expected, std::chrono::nanoseconds timeout) {
+	const auto milliseconds = std::chrono::ceil<std::chrono::milliseconds>(timeout).count();
+	WaitOnAddress(const_cast<std::atomic<std::uint32_t>*>(&address), &expected, sizeof(expected),
+				  milliseconds > 0 ? static_cast<DWORD>(milliseconds) : 0);
+}
+
+void wake_all(const std::atomic<std::uint32_t>& address) {
+	WakeByAddressAll(const_cast<std::atomic<std::uint32_t>*>(&address));
+}
+
+#elif defined(__linux__)
+
+void wait(const std::atomic<std::uint32_t>& address, std::uint32_t expected) {
+	syscall(SYS_futex, &address, FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+}
+
+void wait_for(const std::atomic<std::uint32_t>& address, std::uint32_t expected, std::chrono::nanoseconds timeout) {
+	if (timeout <= std::chrono::nanoseconds::zero())
+		return;
+
+	const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+	timespec relative_timeout;
+	relative_timeout.tv_sec = static_cast<time_t>(seconds.count());
+	relative_timeout.tv_nsec = static_cast<long>((timeout - seconds).count());
+
+	syscall(SYS_futex, &address, FUTEX_WAIT_PRIVATE, expected, &relative_timeout, nullptr, 0);
+}
+
+void wake_all(const std::atomic<std::uint32_t>& address) {
+	syscall(SYS_futex, &address, FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+}
+
+#else
+
+void wait(const std::atomic<std::uint32_t>& address, std::uint32_t expected) {
+	while (address.load(std::memory_order_acquire) == expected)
+		std::this_thread::yield();
+}
+
+void wait_for(const std::atomic<std::uint32_t>& address, std::uint32_t expected, std::chrono::nanoseconds timeout) {
+	const auto deadline = std::chrono::steady_clock::now() + timeout;
+	while (address.load(std::memory_order_acquire) == expected && std::chrono::steady_clock::now() < deadline)
+		std::this_thread::yield();
+}
+
+void wake_all(const std::atomic<std::uint32_t>&) {
+}
+
+#endif
+
+} // namespace futex
+
+} // namespace util
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <ThreadPool_Export.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace util {
+
+/**
+ * @brief Sleeping on the value of an atomic without a mutex and a condition variable
+ *
+ * Uses futex on Linux and WaitOnAddress on Windows. Elsewhere the waiting threads yield until the value changes.
+ * Waking up spuriously is allowed, so the callers must check the value again.
+ */
+namespace futex {
+
+/**
+ * @brief Sleeps while @p address holds @p expected
+ */
+THREADPOOL_EXPORT void wait(const std::atomic<std::uint32_t>& address, std::uint32_t expected);
+
+/**
+ * @brief Sleeps while @p address holds @p expected but no longer than @p timeout
+ */
+THREADPOOL_EXPORT void wait_for(const std::atomic<std::uint32_t>& address, std::uint32_t expected,
+								std::chrono::nanoseconds timeout);
+
+THREADPOOL_EXPORT void wake_all(const std::atomic<std::uint32_t>& address);
+
+} // namespace futex
+
+} // namespace util